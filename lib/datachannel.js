@@ -5,12 +5,20 @@ var inherits = require('util').inherits;
 var EventTarget = require('./eventtarget');
 
 var RTCDataChannelMessageEvent = require('./datachannelmessageevent');
+var RTCDataChannelStream = require('./datachannelstream');
+var SharedRingReader = require('./sharedringreader');
 
 function RTCDataChannel(internalDC) {
   var self = this;
+  var receiveRing = null;
+  var stream = null;
 
   EventTarget.call(this);
 
+  internalDC.onbufferedamountlow = function onbufferedamountlow() {
+    self.dispatchEvent({ type: 'bufferedamountlow' });
+  };
+
   internalDC.onerror = function onerror() {
     self.dispatchEvent({ type: 'error' });
   };
@@ -19,6 +27,21 @@ function RTCDataChannel(internalDC) {
     self.dispatchEvent(new RTCDataChannelMessageEvent(data));
   };
 
+  internalDC.onmessages = function onmessages(data, lengths) {
+    self.dispatchEvent({ type: 'messages', data: data, lengths: lengths });
+  };
+
+  internalDC.onreceiveoverflow = function onreceiveoverflow() {
+    self.dispatchEvent({ type: 'receiveoverflow' });
+  };
+
+  internalDC.onringdata = function onringdata() {
+    if (receiveRing) {
+      SharedRingReader.notify(receiveRing);
+    }
+    self.dispatchEvent({ type: 'ringdata' });
+  };
+
   internalDC.onstatechange = function onstatechange(data) {
     switch (data) {
       case 'open':
@@ -37,6 +60,14 @@ function RTCDataChannel(internalDC) {
         return internalDC.bufferedAmount;
       }
     },
+    bufferedAmountLowThreshold: {
+      get: function getBufferedAmountLowThreshold() {
+        return internalDC.bufferedAmountLowThreshold;
+      },
+      set: function(bufferedAmountLowThreshold) {
+        internalDC.bufferedAmountLowThreshold = bufferedAmountLowThreshold;
+      }
+    },
     id: {
       get: function getId() {
         return internalDC.id;
@@ -89,6 +120,33 @@ function RTCDataChannel(internalDC) {
       set: function(binaryType) {
         internalDC.binaryType = binaryType;
       }
+    },
+    messageBatching: {
+      get: function getMessageBatching() {
+        return internalDC.messageBatching;
+      },
+      set: function(messageBatching) {
+        if (stream && messageBatching !== 'none') {
+          throw new Error('messageBatching must be "none" while a stream is attached');
+        }
+        internalDC.messageBatching = messageBatching;
+      }
+    },
+    compressionThreshold: {
+      get: function getCompressionThreshold() {
+        return internalDC.compressionThreshold;
+      },
+      set: function(compressionThreshold) {
+        internalDC.compressionThreshold = compressionThreshold;
+      }
+    },
+    maxReceivedMessageSize: {
+      get: function getMaxReceivedMessageSize() {
+        return internalDC.maxReceivedMessageSize;
+      },
+      set: function(maxReceivedMessageSize) {
+        internalDC.maxReceivedMessageSize = maxReceivedMessageSize;
+      }
     }
   });
 
@@ -104,6 +162,30 @@ function RTCDataChannel(internalDC) {
     internalDC.send(data);
   };
 
+  this.sendMany = function sendMany(data, offsets) {
+    return internalDC.sendMany(data, offsets);
+  };
+
+  this.createStream = function createStream(options) {
+    // The stream reads "message" events, so batching is turned off for as long
+    // as it is attached.
+    internalDC.messageBatching = 'none';
+    stream = new RTCDataChannelStream(self, internalDC, options);
+    stream.once('close', function onclose() {
+      stream = null;
+    });
+    return stream;
+  };
+
+  this.setReceiveRing = function setReceiveRing(sharedArrayBuffer, overflow) {
+    internalDC.setReceiveRing(sharedArrayBuffer, overflow);
+    receiveRing = sharedArrayBuffer || null;
+  };
+
+  this.getCounters = function getCounters() {
+    return internalDC.getCounters();
+  };
+
   this.close = function close() {
     internalDC.close();
   };
@@ -0,0 +1,105 @@
+'use strict';
+
+var Duplex = require('stream').Duplex;
+var inherits = require('util').inherits;
+
+// Larger messages are split, since SCTP implementations limit message size.
+var MAX_MESSAGE_SIZE = 65536;
+
+/**
+ * A Duplex stream over an RTCDataChannel. Writes wait for bufferedAmount to
+ * drain below the writable high-water mark, and reads pause native message
+ * delivery once the readable high-water mark is reached.
+ *
+ * Pausing affects the whole RTCDataChannel: no "message" events are
+ * dispatched to any listener until the stream reads again. WebRTC cannot stop
+ * reading from SCTP, so while paused, at most options.maxPausedBytes (16 MiB
+ * by default) are held natively; past that, the stream is destroyed with an
+ * error, which closes the RTCDataChannel.
+ *
+ * Ending the writable side leaves the RTCDataChannel open, so that the stream
+ * can keep reading what the remote peer sends; destroying the stream closes
+ * it. With options.allowHalfOpen set to false, ending also closes it.
+ */
+function RTCDataChannelStream(channel, internalDC, options) {
+  Duplex.call(this, options);
+
+  var self = this;
+
+  this._channel = channel;
+  this._internalDC = internalDC;
+  this._maxPausedBytes = options && options.maxPausedBytes;
+  this._onBufferedAmountLow = null;
+
+  channel.bufferedAmountLowThreshold = this._writableState.highWaterMark;
+
+  channel.addEventListener('message', function onmessage(event) {
+    var data = typeof event.data === 'string'
+      ? event.data
+      : Buffer.from(event.data);
+    if (!self.push(data)) {
+      internalDC.pause(self._maxPausedBytes);
+    }
+  });
+
+  channel.addEventListener('receiveoverflow', function onreceiveoverflow() {
+    self.destroy(new Error('RTCDataChannel received more than maxPausedBytes while paused'));
+  });
+
+  channel.addEventListener('bufferedamountlow', function onbufferedamountlow() {
+    var onBufferedAmountLow = self._onBufferedAmountLow;
+    self._onBufferedAmountLow = null;
+    if (onBufferedAmountLow) {
+      onBufferedAmountLow();
+    }
+  });
+
+  channel.addEventListener('close', function onclose() {
+    self.push(null);
+    var onBufferedAmountLow = self._onBufferedAmountLow;
+    self._onBufferedAmountLow = null;
+    if (onBufferedAmountLow) {
+      onBufferedAmountLow(new Error('RTCDataChannel closed'));
+    }
+  });
+}
+
+inherits(RTCDataChannelStream, Duplex);
+
+RTCDataChannelStream.prototype._read = function _read() {
+  this._internalDC.resume();
+};
+
+RTCDataChannelStream.prototype._write = function _write(chunk, encoding, callback) {
+  var bufferedAmount;
+  try {
+    if (typeof chunk === 'string') {
+      chunk = Buffer.from(chunk, encoding);
+    }
+    for (var offset = 0; offset < chunk.length || offset === 0; offset += MAX_MESSAGE_SIZE) {
+      bufferedAmount = this._internalDC.send(chunk.slice(offset, offset + MAX_MESSAGE_SIZE));
+    }
+  } catch (error) {
+    callback(error);
+    return;
+  }
+  if (bufferedAmount > this._writableState.highWaterMark) {
+    this._onBufferedAmountLow = callback;
+    return;
+  }
+  callback();
+};
+
+RTCDataChannelStream.prototype._final = function _final(callback) {
+  if (!this.allowHalfOpen) {
+    this._channel.close();
+  }
+  callback();
+};
+
+RTCDataChannelStream.prototype._destroy = function _destroy(error, callback) {
+  this._channel.close();
+  callback(error);
+};
+
+module.exports = RTCDataChannelStream;
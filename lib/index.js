@@ -23,9 +23,16 @@ exports.RTCRtpTransceiver = binding.RTCRtpTransceiver;
 exports.RTCSessionDescription = require('./sessiondescription');
 
 exports.nonstandard = {};
+exports.nonstandard.getEventLoopBudget = binding.getEventLoopBudget;
+exports.nonstandard.getEventLoopMetrics = binding.getEventLoopMetrics;
+exports.nonstandard.getFastCallbacks = binding.getFastCallbacks;
+exports.nonstandard.getFrameBufferPoolMetrics = binding.getFrameBufferPoolMetrics;
 exports.nonstandard.i420ToRgba = binding.i420ToRgba;
 exports.nonstandard.RTCAudioSink = require('./rtcaudiosink');
 exports.nonstandard.RTCAudioSource = binding.RTCAudioSource;
 exports.nonstandard.RTCVideoSink = require('./rtcvideosink');
 exports.nonstandard.RTCVideoSource = binding.RTCVideoSource;
 exports.nonstandard.rgbaToI420 = binding.rgbaToI420;
+exports.nonstandard.setEventLoopBudget = binding.setEventLoopBudget;
+exports.nonstandard.setFastCallbacks = binding.setFastCallbacks;
+exports.nonstandard.SharedRingReader = require('./sharedringreader');
@@ -17,9 +17,24 @@ function RTCAudioSink(track) {
     }, data));
   };
 
-  Object.defineProperty(this, 'stopped', {
-    get: function() {
-      return self._sink.stopped;
+  Object.defineProperties(this, {
+    dataDropped: {
+      get: function() {
+        return self._sink.dataDropped;
+      }
+    },
+    highWaterMark: {
+      get: function() {
+        return self._sink.highWaterMark;
+      },
+      set: function(highWaterMark) {
+        self._sink.highWaterMark = highWaterMark;
+      }
+    },
+    stopped: {
+      get: function() {
+        return self._sink.stopped;
+      }
     }
   });
 }
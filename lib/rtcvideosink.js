@@ -5,10 +5,10 @@ var inherits = require('util').inherits;
 var NativeRTCVideoSink = require('./binding').RTCVideoSink;
 var EventTarget = require('./eventtarget');
 
-function RTCVideoSink(track) {
+function RTCVideoSink(track, options) {
   EventTarget.call(this);
 
-  this._sink = new NativeRTCVideoSink(track);
+  this._sink = new NativeRTCVideoSink(track, options);
 
   var self = this;
   this._sink.onframe = function onframe(frame) {
@@ -18,9 +18,24 @@ function RTCVideoSink(track) {
     });
   };
 
-  Object.defineProperty(this, 'stopped', {
-    get: function() {
-      return self._sink.stopped;
+  Object.defineProperties(this, {
+    framesDropped: {
+      get: function() {
+        return self._sink.framesDropped;
+      }
+    },
+    highWaterMark: {
+      get: function() {
+        return self._sink.highWaterMark;
+      },
+      set: function(highWaterMark) {
+        self._sink.highWaterMark = highWaterMark;
+      }
+    },
+    stopped: {
+      get: function() {
+        return self._sink.stopped;
+      }
     }
   });
 }
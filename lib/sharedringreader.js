@@ -0,0 +1,70 @@
+'use strict';
+
+// See src/utilities/shared_ring.h for the layout.
+var WRITE_OFFSET = 0;
+var READ_OFFSET = 1;
+var DROPPED = 2;
+var HEADER_SIZE = 16;
+var BINARY = 0x80000000;
+var WRAP = 0xffffffff;
+
+/**
+ * A SharedRingReader reads the messages an RTCDataChannel writes into a
+ * SharedArrayBuffer registered with setReceiveRing. It works on any thread,
+ * including in a worker.
+ */
+function SharedRingReader(sharedArrayBuffer) {
+  this._header = new Int32Array(sharedArrayBuffer, 0, HEADER_SIZE / 4);
+  this._data = new Uint8Array(sharedArrayBuffer, HEADER_SIZE);
+  this._words = new Uint32Array(sharedArrayBuffer, HEADER_SIZE, this._data.length >>> 2);
+  this._capacity = this._words.length * 4;
+
+  var self = this;
+  Object.defineProperties(this, {
+    dropped: {
+      get: function getDropped() {
+        return Atomics.load(self._header, DROPPED) >>> 0;
+      }
+    }
+  });
+}
+
+/**
+ * Read the next message: an ArrayBuffer for binary messages, a string for text
+ * messages, or null if the ring is empty.
+ */
+SharedRingReader.prototype.read = function read() {
+  var offset = Atomics.load(this._header, READ_OFFSET);
+  if (offset === Atomics.load(this._header, WRITE_OFFSET)) {
+    return null;
+  }
+  var length = this._words[offset >>> 2];
+  if (length === WRAP) {
+    offset = 0;
+    length = this._words[0];
+  }
+  var binary = (length & BINARY) !== 0;
+  length = (length & ~BINARY) >>> 0;
+  var start = offset + 4;
+  var bytes = this._data.slice(start, start + length);
+  var next = start + ((length + 3) & ~3);
+  Atomics.store(this._header, READ_OFFSET, next === this._capacity ? 0 : next);
+  return binary ? bytes.buffer : Buffer.from(bytes.buffer).toString('utf8');
+};
+
+/**
+ * Wait for the ring to be non-empty, using Atomics.wait (which the main thread
+ * cannot do). RTCDataChannel wakes waiters whenever it dispatches "ringdata".
+ * @param {number} [timeout] - timeout, in milliseconds
+ */
+SharedRingReader.prototype.wait = function wait(timeout) {
+  var offset = Atomics.load(this._header, READ_OFFSET);
+  return Atomics.wait(this._header, WRITE_OFFSET, offset, timeout);
+};
+
+SharedRingReader.notify = function notify(sharedArrayBuffer) {
+  var header = new Int32Array(sharedArrayBuffer, 0, HEADER_SIZE / 4);
+  return (Atomics.notify || Atomics.wake)(header, WRITE_OFFSET);
+};
+
+module.exports = SharedRingReader;
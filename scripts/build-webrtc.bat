@@ -6,7 +6,7 @@ set PATH=%DEPOT_TOOLS%;%PATH%
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 
 ECHO ninja
-call ninja webrtc libjingle_peerconnection -j 2
+call ninja webrtc libjingle_peerconnection third_party/zlib -j 2
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 
 GOTO DONE
@@ -6,7 +6,7 @@ set -v
 
 export PATH=$DEPOT_TOOLS:$PATH
 
-export TARGETS="webrtc libjingle_peerconnection"
+export TARGETS="webrtc libjingle_peerconnection third_party/zlib"
 if [[ "$TARGET_ARCH" == arm* ]]; then
   export TARGETS="$TARGETS pc:peerconnection libc++ libc++abi"
 fi
@@ -5,6 +5,8 @@
  * project authors may be found in the AUTHORS file in the root of the source
  * tree.
  */
+#include <mutex>
+
 #include <node.h>
 #include <v8.h>
 
@@ -23,6 +25,8 @@
 #include "src/interfaces/rtc_stats_response.h"
 #include "src/interfaces/rtc_video_sink.h"
 #include "src/interfaces/rtc_video_source.h"
+#include "src/methods/event_loop_helpers.h"
+#include "src/methods/frame_buffer_pool_helpers.h"
 #include "src/methods/get_user_media.h"
 #include "src/methods/i420_helpers.h"
 #include "src/node/error_factory.h"
@@ -35,8 +39,14 @@ static void dispose(void*) {
   node_webrtc::PeerConnectionFactory::Dispose();
 }
 
-static void init(v8::Handle<v8::Object> exports, v8::Handle<v8::Object> module) {
-  node_webrtc::ErrorFactory::Init(module);
+static void init(
+    v8::Local<v8::Object> exports,
+    v8::Local<v8::Value> module,
+    v8::Local<v8::Context>,
+    void*) {
+  node_webrtc::ErrorFactory::Init(module.As<v8::Object>());
+  node_webrtc::EventLoopHelpers::Init(exports);
+  node_webrtc::FrameBufferPoolHelpers::Init(exports);
   node_webrtc::GetUserMedia::Init(exports);
   node_webrtc::I420Helpers::Init(exports);
   node_webrtc::PeerConnectionFactory::Init(exports);
@@ -57,7 +67,13 @@ static void init(v8::Handle<v8::Object> exports, v8::Handle<v8::Object> module)
 #ifdef DEBUG
   node_webrtc::Test::Init(exports);
 #endif
-  node::AtExit(dispose);
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    node::AtExit(dispose);
+  });
 }
 
-NODE_MODULE(wrtc, init)
+// The addon is context-aware, so that it can be loaded from
+// worker_threads. Every JavaScript thread gets its own constructors, wrappers,
+// EventDispatcher and default PeerConnectionFactory.
+NODE_MODULE_CONTEXT_AWARE(wrtc, init)
@@ -0,0 +1,36 @@
+#include "src/dictionaries/node_webrtc/event_loop_budget.h"
+
+#include <nan.h>
+#include <v8.h>
+
+#include "src/converters/v8.h"
+#include "src/functional/maybe.h"
+#include "src/functional/validation.h"
+
+namespace node_webrtc {
+
+#define EVENT_LOOP_BUDGET_FN CreateEventLoopBudget
+
+static Validation<EVENT_LOOP_BUDGET> EVENT_LOOP_BUDGET_FN(
+    const Maybe<uint32_t>& maxEvents,
+    const Maybe<uint32_t>& maxTime) {
+  return Pure<EVENT_LOOP_BUDGET>({maxEvents, maxTime});
+}
+
+TO_JS_IMPL(EVENT_LOOP_BUDGET, value) {
+  Nan::EscapableHandleScope scope;
+  auto object = Nan::New<v8::Object>();
+  if (value.maxEvents.IsJust()) {
+    object->Set(Nan::New("maxEvents").ToLocalChecked(), Nan::New(value.maxEvents.UnsafeFromJust()));
+  }
+  if (value.maxTime.IsJust()) {
+    object->Set(Nan::New("maxTime").ToLocalChecked(), Nan::New(value.maxTime.UnsafeFromJust()));
+  }
+  return Pure(scope.Escape(object.As<v8::Value>()));
+}
+
+}  // namespace node_webrtc
+
+#define DICT(X) EVENT_LOOP_BUDGET ## X
+#include "src/dictionaries/macros/impls.h"
+#undef DICT
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// IWYU pragma: no_forward_declare node_webrtc::EventLoopBudget
+// IWYU pragma: no_include "src/dictionaries/macros/impls.h"
+
+#define EVENT_LOOP_BUDGET EventLoopBudget
+#define EVENT_LOOP_BUDGET_LIST \
+  DICT_OPTIONAL(uint32_t, maxEvents, "maxEvents") \
+  DICT_OPTIONAL(uint32_t, maxTime, "maxTime")
+
+#define DICT(X) EVENT_LOOP_BUDGET ## X
+#include "src/dictionaries/macros/def.h"
+#include "src/dictionaries/macros/decls.h"
+#undef DICT
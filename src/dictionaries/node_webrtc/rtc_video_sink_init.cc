@@ -0,0 +1,29 @@
+#include "src/dictionaries/node_webrtc/rtc_video_sink_init.h"
+
+#include "src/functional/maybe.h"
+#include "src/functional/validation.h"
+
+namespace node_webrtc {
+
+#define RTC_VIDEO_SINK_INIT_FN CreateRTCVideoSinkInit
+
+static Validation<RTC_VIDEO_SINK_INIT> RTC_VIDEO_SINK_INIT_FN(
+    const bool coalesce,
+    const Maybe<uint32_t> maxPixelCount,
+    const Maybe<double> maxFramerate,
+    const Maybe<VideoResolution> scaleResolutionTo,
+    const VideoFrameFormat format) {
+  if (maxPixelCount.FromMaybe(1) == 0) {
+    return Validation<RTC_VIDEO_SINK_INIT>::Invalid("Expected maxPixelCount to be greater than 0");
+  }
+  if (!(maxFramerate.FromMaybe(1) > 0)) {
+    return Validation<RTC_VIDEO_SINK_INIT>::Invalid("Expected maxFramerate to be greater than 0");
+  }
+  return Pure<RTC_VIDEO_SINK_INIT>({coalesce, maxPixelCount, maxFramerate, scaleResolutionTo, format});
+}
+
+}  // namespace node_webrtc
+
+#define DICT(X) RTC_VIDEO_SINK_INIT ## X
+#include "src/dictionaries/macros/impls.h"
+#undef DICT
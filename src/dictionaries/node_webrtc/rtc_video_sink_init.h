@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "src/dictionaries/node_webrtc/video_resolution.h"
+#include "src/enums/node_webrtc/video_frame_format.h"
+
+// IWYU pragma: no_forward_declare node_webrtc::RTCVideoSinkInit
+// IWYU pragma: no_include "src/dictionaries/macros/impls.h"
+
+#define RTC_VIDEO_SINK_INIT RTCVideoSinkInit
+#define RTC_VIDEO_SINK_INIT_LIST \
+  DICT_DEFAULT(bool, coalesce, "coalesce", false) \
+  DICT_OPTIONAL(uint32_t, maxPixelCount, "maxPixelCount") \
+  DICT_OPTIONAL(double, maxFramerate, "maxFramerate") \
+  DICT_OPTIONAL(VideoResolution, scaleResolutionTo, "scaleResolutionTo") \
+  DICT_DEFAULT(VideoFrameFormat, format, "format", VideoFrameFormat::kI420)
+
+#define DICT(X) RTC_VIDEO_SINK_INIT ## X
+#include "src/dictionaries/macros/def.h"
+#include "src/dictionaries/macros/decls.h"
+#undef DICT
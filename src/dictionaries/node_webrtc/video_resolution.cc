@@ -0,0 +1,34 @@
+#include "src/dictionaries/node_webrtc/video_resolution.h"
+
+#include <nan.h>
+#include <v8.h>
+
+#include "src/converters/v8.h"
+#include "src/functional/validation.h"
+
+namespace node_webrtc {
+
+#define VIDEO_RESOLUTION_FN CreateVideoResolution
+
+static Validation<VIDEO_RESOLUTION> VIDEO_RESOLUTION_FN(
+    const uint32_t width,
+    const uint32_t height) {
+  if (!width || !height || width > 16384 || height > 16384) {
+    return Validation<VIDEO_RESOLUTION>::Invalid("Expected width and height to be between 1 and 16384");
+  }
+  return Pure<VIDEO_RESOLUTION>({width, height});
+}
+
+TO_JS_IMPL(VIDEO_RESOLUTION, value) {
+  Nan::EscapableHandleScope scope;
+  auto object = Nan::New<v8::Object>();
+  object->Set(Nan::New("width").ToLocalChecked(), Nan::New(value.width));
+  object->Set(Nan::New("height").ToLocalChecked(), Nan::New(value.height));
+  return Pure(scope.Escape(object.As<v8::Value>()));
+}
+
+}  // namespace node_webrtc
+
+#define DICT(X) VIDEO_RESOLUTION ## X
+#include "src/dictionaries/macros/impls.h"
+#undef DICT
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// IWYU pragma: no_forward_declare node_webrtc::VideoResolution
+// IWYU pragma: no_include "src/dictionaries/macros/impls.h"
+
+#define VIDEO_RESOLUTION VideoResolution
+#define VIDEO_RESOLUTION_LIST \
+  DICT_REQUIRED(uint32_t, width, "width") \
+  DICT_REQUIRED(uint32_t, height, "height")
+
+#define DICT(X) VIDEO_RESOLUTION ## X
+#include "src/dictionaries/macros/def.h"
+#include "src/dictionaries/macros/decls.h"
+#undef DICT
@@ -8,9 +8,46 @@
 #include "src/converters.h"
 #include "src/dictionaries/webrtc/video_frame_buffer.h"  // IWYU pragma: keep
 #include "src/functional/validation.h"
+#include "src/node/external_array_buffer.h"
+#include "src/webrtc/converted_video_frame_buffer.h"
 
 namespace node_webrtc {
 
+/**
+ * Describe where a plane starts in a frame's data, and how many bytes each of
+ * its rows take.
+ */
+static v8::Local<v8::Object> CreatePlaneLayout(size_t offset, int stride) {
+  Nan::EscapableHandleScope scope;
+  auto plane = Nan::New<v8::Object>();
+  plane->Set(Nan::New("offset").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(offset)));
+  plane->Set(Nan::New("stride").ToLocalChecked(), Nan::New<v8::Number>(stride));
+  return scope.Escape(plane);
+}
+
+/**
+ * frame.release() hands the frame's data back to the FrameBufferPool without
+ * waiting for garbage collection. Afterwards, frame.data is empty.
+ */
+static NAN_METHOD(ReleaseFrame) {
+  auto data = Nan::Get(info.This(), Nan::New("data").ToLocalChecked());
+  if (!data.IsEmpty() && data.ToLocalChecked()->IsTypedArray()) {
+    auto arrayBuffer = data.ToLocalChecked().As<v8::TypedArray>()->Buffer();
+    info.GetReturnValue().Set(ExternalArrayBuffer::Release(arrayBuffer));
+    return;
+  }
+  info.GetReturnValue().Set(false);
+}
+
+static v8::Local<v8::Function> CreateReleaseFrame() {
+  Nan::EscapableHandleScope scope;
+  static thread_local Nan::Persistent<v8::Function> releaseFrame;
+  if (releaseFrame.IsEmpty()) {
+    releaseFrame.Reset(Nan::GetFunction(Nan::New<v8::FunctionTemplate>(ReleaseFrame)).ToLocalChecked());
+  }
+  return scope.Escape(Nan::New(releaseFrame));
+}
+
 TO_JS_IMPL(webrtc::VideoFrame, value) {
   Nan::EscapableHandleScope scope;
   auto frame = Nan::New<v8::Object>();
@@ -23,6 +60,56 @@ TO_JS_IMPL(webrtc::VideoFrame, value) {
   }
   auto data = maybeData.UnsafeFromValid();
   frame->Set(Nan::New("data").ToLocalChecked(), data);
+  auto buffer = value.video_frame_buffer();
+  if (buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
+    I420Layout layout(*buffer->GetI420());
+    auto planes = Nan::New<v8::Array>(3);
+    for (uint32_t i = 0; i < 3; i++) {
+      planes->Set(i, CreatePlaneLayout(layout.offsets[i], layout.strides[i]));
+    }
+    frame->Set(Nan::New("layout").ToLocalChecked(), planes);
+  }
+  return Pure(scope.Escape(frame).As<v8::Value>());
+}
+
+TO_JS_IMPL(FormattedVideoFrame, value) {
+  Nan::EscapableHandleScope scope;
+  auto const& videoFrame = value.first;
+  auto format = value.second;
+  auto maybeFormat = From<v8::Local<v8::Value>>(format);
+  if (maybeFormat.IsInvalid()) {
+    return Validation<v8::Local<v8::Value>>::Invalid(maybeFormat.ToErrors()[0]);
+  }
+
+  if (format == VideoFrameFormat::kI420) {
+    auto maybeFrame = From<v8::Local<v8::Value>>(videoFrame);
+    if (maybeFrame.IsInvalid()) {
+      return maybeFrame;
+    }
+    auto frame = maybeFrame.UnsafeFromValid().As<v8::Object>();
+    frame->Set(Nan::New("format").ToLocalChecked(), maybeFormat.UnsafeFromValid());
+    frame->Set(Nan::New("release").ToLocalChecked(), CreateReleaseFrame());
+    return Pure(scope.Escape(frame).As<v8::Value>());
+  }
+
+  // The caller guarantees that the buffer is a ConvertedVideoFrameBuffer. Its
+  // data is shared with JavaScript, rather than copied.
+  rtc::scoped_refptr<ConvertedVideoFrameBuffer> buffer(
+      static_cast<ConvertedVideoFrameBuffer*>(videoFrame.video_frame_buffer().get()));
+  auto frame = Nan::New<v8::Object>();
+  frame->Set(Nan::New("width").ToLocalChecked(), From<v8::Local<v8::Value>>(videoFrame.width()).UnsafeFromValid());
+  frame->Set(Nan::New("height").ToLocalChecked(), From<v8::Local<v8::Value>>(videoFrame.height()).UnsafeFromValid());
+  frame->Set(Nan::New("rotation").ToLocalChecked(), From<v8::Local<v8::Value>>(static_cast<int>(videoFrame.rotation())).UnsafeFromValid());
+  frame->Set(Nan::New("format").ToLocalChecked(), maybeFormat.UnsafeFromValid());
+  auto size = buffer->size();
+  auto arrayBuffer = ExternalArrayBuffer::NewReleasable(const_cast<uint8_t*>(buffer->data()), size, buffer);
+  frame->Set(Nan::New("data").ToLocalChecked(), v8::Uint8ClampedArray::New(arrayBuffer, 0, size));
+  auto planes = Nan::New<v8::Array>(static_cast<int>(buffer->number_of_planes()));
+  for (uint32_t i = 0; i < buffer->number_of_planes(); i++) {
+    planes->Set(i, CreatePlaneLayout(buffer->offset(i), buffer->stride(i)));
+  }
+  frame->Set(Nan::New("layout").ToLocalChecked(), planes);
+  frame->Set(Nan::New("release").ToLocalChecked(), CreateReleaseFrame());
   return Pure(scope.Escape(frame).As<v8::Value>());
 }
 
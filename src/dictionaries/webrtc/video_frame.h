@@ -1,11 +1,21 @@
 #pragma once
 
+#include <utility>
+
 #include "src/converters/v8.h"
+#include "src/enums/node_webrtc/video_frame_format.h"
 
 namespace webrtc { class VideoFrame; }
 
 namespace node_webrtc {
 
+/**
+ * A webrtc::VideoFrame and the VideoFrameFormat of its data. Frames in any
+ * format but kI420 must have a ConvertedVideoFrameBuffer.
+ */
+typedef std::pair<webrtc::VideoFrame, VideoFrameFormat> FormattedVideoFrame;
+
 DECLARE_TO_JS(webrtc::VideoFrame)
+DECLARE_TO_JS(FormattedVideoFrame)
 
 }  // namespace node_webrtc
@@ -1,23 +1,27 @@
 #include "src/dictionaries/webrtc/video_frame_buffer.h"
 
+#include <cstring>
+
 #include <nan.h>
-#include <webrtc/api/video/i420_buffer.h>
+#include <webrtc/api/video/video_frame_buffer.h>
 
 #include "src/dictionaries/node_webrtc/image_data.h"
 #include "src/functional/validation.h"
+#include "src/node/external_array_buffer.h"
+#include "src/webrtc/frame_buffer_pool.h"
 
 namespace node_webrtc {
 
-static rtc::scoped_refptr<webrtc::I420Buffer> CreateI420Buffer(
+static rtc::scoped_refptr<PooledI420Buffer> CreateI420Buffer(
     I420ImageData i420Frame) {
-  auto buffer = webrtc::I420Buffer::Create(i420Frame.width(), i420Frame.height());
+  auto buffer = PooledI420Buffer::Create(i420Frame.width(), i420Frame.height());
   memcpy(buffer->MutableDataY(), i420Frame.dataY(), i420Frame.sizeOfLuminancePlane());
   memcpy(buffer->MutableDataU(), i420Frame.dataU(), i420Frame.sizeOfChromaPlane());
   memcpy(buffer->MutableDataV(), i420Frame.dataV(), i420Frame.sizeOfChromaPlane());
   return buffer;
 }
 
-CONVERTER_IMPL(I420ImageData, rtc::scoped_refptr<webrtc::I420Buffer>, value) {
+CONVERTER_IMPL(I420ImageData, rtc::scoped_refptr<PooledI420Buffer>, value) {
   return Pure(CreateI420Buffer(value));
 }
 
@@ -27,34 +31,45 @@ TO_JS_IMPL(rtc::scoped_refptr<webrtc::VideoFrameBuffer>, value) {
       : node_webrtc::Validation<v8::Local<v8::Value>>::Invalid("Unsupported RTCVideoFrame type (file a node-webrtc bug, please!)");
 }
 
+I420Layout::I420Layout(const webrtc::I420BufferInterface& buffer) {
+  auto chromaHeight = static_cast<size_t>(buffer.ChromaHeight());
+  strides[0] = buffer.StrideY();
+  strides[1] = buffer.StrideU();
+  strides[2] = buffer.StrideV();
+  offsets[0] = 0;
+  offsets[1] = static_cast<size_t>(strides[0]) * static_cast<size_t>(buffer.height());
+  offsets[2] = offsets[1] + static_cast<size_t>(strides[1]) * chromaHeight;
+  byteLength = offsets[2] + static_cast<size_t>(strides[2]) * chromaHeight;
+}
+
 TO_JS_IMPL(rtc::scoped_refptr<webrtc::I420BufferInterface>, value) {
   Nan::EscapableHandleScope scope;
-  auto isolate = Nan::GetCurrentContext()->GetIsolate();
-
-  auto sizeOfYPlane = value->StrideY() * value->height();
-  auto sizeOfUPlane = value->StrideU() * value->height() / 2;
-  auto sizeOfVPlane = value->StrideV() * value->height() / 2;
-
-  auto byteLength = sizeOfYPlane + sizeOfUPlane + sizeOfVPlane;
-  auto arrayBuffer = v8::ArrayBuffer::New(isolate, byteLength);
-  uint8_t* data = static_cast<uint8_t*>(arrayBuffer->GetContents().Data());
 
+  I420Layout layout(*value);
   auto srcYPlane = value->DataY();
   auto srcUPlane = value->DataU();
   auto srcVPlane = value->DataV();
 
-  auto dstYPlane = data;
-  auto dstUPlane = data + sizeOfYPlane;
-  auto dstVPlane = dstUPlane + sizeOfUPlane;
-
-  memcpy(dstYPlane, srcYPlane, sizeOfYPlane);
-  memcpy(dstUPlane, srcUPlane, sizeOfUPlane);
-  memcpy(dstVPlane, srcVPlane, sizeOfVPlane);
+  // Buffers that keep their planes back to back (like webrtc::I420Buffer and
+  // PooledI420Buffer) are shared with JavaScript, rather than copied, for as
+  // long as the Uint8ClampedArray is reachable (or until it is released). Other
+  // buffers are copied into PooledMemory.
+  v8::Local<v8::ArrayBuffer> arrayBuffer;
+  if (srcUPlane == srcYPlane + layout.offsets[1] && srcVPlane == srcYPlane + layout.offsets[2]) {
+    arrayBuffer = ExternalArrayBuffer::NewReleasable(const_cast<uint8_t*>(srcYPlane), layout.byteLength, value);
+  } else {
+    auto memory = FrameBufferPool::Default().Acquire(layout.byteLength);
+    auto data = memory->data();
+    memcpy(data + layout.offsets[0], srcYPlane, layout.offsets[1] - layout.offsets[0]);
+    memcpy(data + layout.offsets[1], srcUPlane, layout.offsets[2] - layout.offsets[1]);
+    memcpy(data + layout.offsets[2], srcVPlane, layout.byteLength - layout.offsets[2]);
+    arrayBuffer = ExternalArrayBuffer::NewReleasable(data, layout.byteLength, memory);
+  }
 
-  auto uint8Array = v8::Uint8ClampedArray::New(arrayBuffer, 0, byteLength);
+  auto uint8Array = v8::Uint8ClampedArray::New(arrayBuffer, 0, arrayBuffer->ByteLength());
   return node_webrtc::Pure(scope.Escape(uint8Array.As<v8::Value>()));
 }
 
-CONVERT_VIA(v8::Local<v8::Value>, I420ImageData, rtc::scoped_refptr<webrtc::I420Buffer>)
+CONVERT_VIA(v8::Local<v8::Value>, I420ImageData, rtc::scoped_refptr<PooledI420Buffer>)
 
 } //  namespace node_webrtc
@@ -1,19 +1,34 @@
 #pragma once
 
+#include <cstddef>
+
 #include "src/converters.h"
 #include "src/converters/v8.h"
 
 namespace rtc { template <typename T> class scoped_refptr; }
-namespace webrtc { class I420Buffer; }
 namespace webrtc { class I420BufferInterface; }
 namespace webrtc { class VideoFrameBuffer; }
 
 namespace node_webrtc {
 
 class I420ImageData;
+class PooledI420Buffer;
+
+/**
+ * I420Layout describes where each plane of an I420 buffer sits in the
+ * Uint8ClampedArray it converts to: Y, then U, then V, each with the buffer's
+ * own stride.
+ */
+struct I420Layout {
+  explicit I420Layout(const webrtc::I420BufferInterface& buffer);
+
+  size_t offsets[3];
+  int strides[3];
+  size_t byteLength;
+};
 
-DECLARE_CONVERTER(I420ImageData, rtc::scoped_refptr<webrtc::I420Buffer>)
-DECLARE_FROM_JS(rtc::scoped_refptr<webrtc::I420Buffer>)
+DECLARE_CONVERTER(I420ImageData, rtc::scoped_refptr<PooledI420Buffer>)
+DECLARE_FROM_JS(rtc::scoped_refptr<PooledI420Buffer>)
 DECLARE_TO_JS(rtc::scoped_refptr<webrtc::I420BufferInterface>)
 DECLARE_TO_JS(rtc::scoped_refptr<webrtc::VideoFrameBuffer>)
 
@@ -0,0 +1,5 @@
+#include "src/enums/node_webrtc/message_batching.h"
+
+#define ENUM(X) MESSAGE_BATCHING ## X
+#include "src/enums/macros/impls.h"
+#undef ENUM
@@ -0,0 +1,15 @@
+#pragma once
+
+// IWYU pragma: no_include "src/enums/macros/impls.h"
+
+#define MESSAGE_BATCHING MessageBatching
+#define MESSAGE_BATCHING_NAME "MessageBatching"
+#define MESSAGE_BATCHING_LIST \
+  ENUM_SUPPORTED(kNone, "none") \
+  ENUM_SUPPORTED(kArray, "array") \
+  ENUM_SUPPORTED(kPacked, "packed")
+
+#define ENUM(X) MESSAGE_BATCHING ## X
+#include "src/enums/macros/def.h"
+#include "src/enums/macros/decls.h"
+#undef ENUM
@@ -0,0 +1,5 @@
+#include "src/enums/node_webrtc/ring_overflow.h"
+
+#define ENUM(X) RING_OVERFLOW ## X
+#include "src/enums/macros/impls.h"
+#undef ENUM
@@ -0,0 +1,14 @@
+#pragma once
+
+// IWYU pragma: no_include "src/enums/macros/impls.h"
+
+#define RING_OVERFLOW RingOverflow
+#define RING_OVERFLOW_NAME "RingOverflow"
+#define RING_OVERFLOW_LIST \
+  ENUM_SUPPORTED(kDrop, "drop") \
+  ENUM_SUPPORTED(kMessage, "message")
+
+#define ENUM(X) RING_OVERFLOW ## X
+#include "src/enums/macros/def.h"
+#include "src/enums/macros/decls.h"
+#undef ENUM
@@ -0,0 +1,16 @@
+#pragma once
+
+// IWYU pragma: no_include "src/enums/macros/impls.h"
+
+#define VIDEO_FRAME_FORMAT VideoFrameFormat
+#define VIDEO_FRAME_FORMAT_NAME "VideoFrameFormat"
+#define VIDEO_FRAME_FORMAT_LIST \
+  ENUM_SUPPORTED(kI420, "I420") \
+  ENUM_SUPPORTED(kRGBA, "RGBA") \
+  ENUM_SUPPORTED(kBGRA, "BGRA") \
+  ENUM_SUPPORTED(kNV12, "NV12")
+
+#define ENUM(X) VIDEO_FRAME_FORMAT ## X
+#include "src/enums/macros/def.h"
+#include "src/enums/macros/decls.h"
+#undef ENUM
@@ -23,12 +23,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& MediaStream::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& MediaStream::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -237,7 +237,7 @@ MediaStream*,
 rtc::scoped_refptr<webrtc::MediaStreamInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * MediaStream::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   MediaStream*,
   rtc::scoped_refptr<webrtc::MediaStreamInterface>,
   std::shared_ptr<PeerConnectionFactory>
@@ -19,12 +19,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& MediaStreamTrack::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& MediaStreamTrack::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -149,7 +149,7 @@ MediaStreamTrack*,
 rtc::scoped_refptr<webrtc::MediaStreamTrackInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * MediaStreamTrack::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   MediaStreamTrack*,
   rtc::scoped_refptr<webrtc::MediaStreamTrackInterface>,
   std::shared_ptr<PeerConnectionFactory>
@@ -16,6 +16,7 @@
 
 #include "src/converters.h"
 #include "src/converters/arguments.h"
+#include "src/converters/v8.h"  // IWYU pragma: keep
 #include "src/dictionaries/node_webrtc/rtc_on_data_event_dict.h"
 #include "src/functional/maybe.h"
 #include "src/functional/validation.h"
@@ -25,12 +26,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::FunctionTemplate>& RTCAudioSink::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
 RTCAudioSink::RTCAudioSink(rtc::scoped_refptr<webrtc::AudioTrackInterface> track)
-  : AsyncObjectWrapWithLoop<RTCAudioSink>("RTCAudioSink", *this)
+  : AsyncObjectWrapWithLoop<RTCAudioSink>("RTCAudioSink", *this, OverflowPolicy::kDropNewest)
   , _track(std::move(track)) {
   _track->AddSink(this);
 }
@@ -51,6 +52,25 @@ NAN_GETTER(RTCAudioSink::GetStopped) {
   info.GetReturnValue().Set(self->_stopped);
 }
 
+NAN_GETTER(RTCAudioSink::GetDataDropped) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCAudioSink>::Unwrap(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(self->dropped())));
+}
+
+NAN_GETTER(RTCAudioSink::GetHighWaterMark) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCAudioSink>::Unwrap(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->high_water_mark()));
+}
+
+NAN_SETTER(RTCAudioSink::SetHighWaterMark) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCAudioSink>::Unwrap(info.Holder());
+  CONVERT_OR_THROW_AND_RETURN(value, highWaterMark, uint32_t)
+  self->set_high_water_mark(highWaterMark);
+}
+
 void RTCAudioSink::Stop() {
   if (_track) {
     _stopped = true;
@@ -107,7 +127,7 @@ void RTCAudioSink::OnData(
     v8::Local<v8::Value> argv[1];
     argv[0] = value;
     MakeCallback("ondata", 1, argv);
-  }));
+  }), EventPriority::kBulk);
 }
 
 void RTCAudioSink::Init(v8::Handle<v8::Object> exports) {
@@ -116,6 +136,8 @@ void RTCAudioSink::Init(v8::Handle<v8::Object> exports) {
   tpl->SetClassName(Nan::New("RTCAudioSink").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("stopped").ToLocalChecked(), GetStopped, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("dataDropped").ToLocalChecked(), GetDataDropped, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("highWaterMark").ToLocalChecked(), GetHighWaterMark, SetHighWaterMark);
   Nan::SetPrototypeMethod(tpl, "stop", JsStop);
   exports->Set(Nan::New("RTCAudioSink").ToLocalChecked(), tpl->GetFunction());
 }
@@ -48,6 +48,12 @@ class RTCAudioSink
 
   static NAN_GETTER(GetStopped);
 
+  static NAN_GETTER(GetDataDropped);
+
+  static NAN_GETTER(GetHighWaterMark);
+
+  static NAN_SETTER(SetHighWaterMark);
+
   static NAN_METHOD(JsStop);
 
   bool _stopped = false;
@@ -7,56 +7,119 @@
  */
 #include "src/interfaces/rtc_data_channel.h"
 
+#include <cstdint>
+#include <cstring>
 #include <utility>
+#include <vector>
 
+#include <uv.h>
 #include <v8.h>
 #include <webrtc/api/data_channel_interface.h>
 #include <webrtc/api/scoped_refptr.h>
 #include <webrtc/rtc_base/copy_on_write_buffer.h>
+#include <webrtc/rtc_base/thread.h>
 
 #include "src/enums/webrtc/data_state.h"
+#include "src/functional/maybe.h"
+#include "src/interfaces/rtc_peer_connection/peer_connection_factory.h"
 #include "src/node/error_factory.h"
 #include "src/node/events.h"
+#include "src/node/external_array_buffer.h"
 
 namespace node_webrtc {
 
+constexpr uint32_t RTCDataChannel::kDefaultPausedLimit;
+
 Nan::Persistent<v8::Function>& RTCDataChannel::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 DataChannelObserver::DataChannelObserver(std::shared_ptr<PeerConnectionFactory> factory,
     rtc::scoped_refptr<webrtc::DataChannelInterface> jingleDataChannel):
   _factory(std::move(factory))
-  , _jingleDataChannel(std::move(jingleDataChannel)) {
+  , _jingleDataChannel(std::move(jingleDataChannel))
+  , _counters(std::make_shared<DataChannelCounters>()) {
+  auto protocol = _jingleDataChannel->protocol();
+  if (DataChannelFraming::IsEnabled(protocol)) {
+    _framing = std::unique_ptr<DataChannelFraming>(new DataChannelFraming());
+  }
+  _compressed = DataChannelCompression::IsEnabled(protocol);
   _jingleDataChannel->RegisterObserver(this);
 }
 
+/**
+ * Reassemble and decompress a received message, if the RTCDataChannel uses
+ * DataChannelFraming or DataChannelCompression.
+ * @return false if buffer did not complete a message, or the message was malformed
+ *   or decompressed to more than max_message_size
+ */
+static bool Decode(DataChannelFraming* framing, bool compressed, size_t max_message_size,
+    const webrtc::DataBuffer& buffer, webrtc::DataBuffer* message) {
+  if (!compressed) {
+    return !framing || framing->Reassemble(buffer, message);
+  }
+  webrtc::DataBuffer reassembled(buffer);
+  if (framing && !framing->Reassemble(buffer, &reassembled)) {
+    return false;
+  }
+  return DataChannelCompression::Decompress(reassembled, max_message_size, message);
+}
+
+/**
+ * Messages are kBulk Events. Closing and closed state changes are kBulk, too,
+ * so that they are never dispatched before the messages that preceded them.
+ */
+static EventPriority PriorityOf(webrtc::DataChannelInterface::DataState state) {
+  return state == webrtc::DataChannelInterface::kClosing || state == webrtc::DataChannelInterface::kClosed
+      ? EventPriority::kBulk
+      : EventPriority::kControl;
+}
+
 void DataChannelObserver::OnStateChange() {
   auto state = _jingleDataChannel->state();
-  Enqueue(Callback1<RTCDataChannel>::Create([state](RTCDataChannel & channel) {
+  Enqueue(CreateCallback1<RTCDataChannel>([state](RTCDataChannel & channel) {
     RTCDataChannel::HandleStateChange(channel, state);
-  }));
+  }), PriorityOf(state));
 }
 
 void DataChannelObserver::OnMessage(const webrtc::DataBuffer& buffer) {
-  Enqueue(Callback1<RTCDataChannel>::Create([buffer](RTCDataChannel & channel) {
-    RTCDataChannel::HandleMessage(channel, buffer);
-  }));
+  webrtc::DataBuffer message(buffer);
+  if (!Decode(_framing.get(), _compressed, DataChannelFraming::kMaxMessageSize, buffer, &message)) {
+    return;
+  }
+  _counters->DidReceive(message.size());
+  auto enqueued_at = uv_hrtime();
+  Enqueue(CreateCallback1<RTCDataChannel>([message, enqueued_at](RTCDataChannel & channel) {
+    channel._counters->DidQueue((uv_hrtime() - enqueued_at) / 1000);
+    RTCDataChannel::HandleMessage(channel, message);
+  }), EventPriority::kBulk);
 }
 
 static void requeue(DataChannelObserver& observer, RTCDataChannel& channel) {
   while (auto event = observer.Dequeue()) {
-    channel.Dispatch(std::move(event));
+    auto priority = event->priority();
+    channel.Dispatch(std::move(event), priority);
   }
 }
 
 RTCDataChannel::RTCDataChannel(node_webrtc::DataChannelObserver* observer)
   : AsyncObjectWrapWithLoop<RTCDataChannel>("RTCDataChannel", *this)
   , _binaryType(BinaryType::kArrayBuffer)
+  , _message_batching(MessageBatching::kNone)
+  , _buffered_amount_low_threshold(0)
   , _factory(observer->_factory)
   , _jingleDataChannel(observer->_jingleDataChannel) {
-  _jingleDataChannel->RegisterObserver(this);
+  // Take over the observer's state before registering, so that no message
+  // reaches this RTCDataChannel ahead of it. Doing both on the signaling thread
+  // also keeps the observer from receiving a message in between; any message it
+  // was part way through reassembling continues here.
+  _factory->_signalingThread->Invoke<void>(RTC_FROM_HERE, [this, observer]() {
+    _framing = std::move(observer->_framing);
+    _compressed = observer->_compressed;
+    _counters = observer->_counters;
+    _jingleDataChannel->RegisterObserver(this);
+  });
 
   // Re-queue cached observer events
   requeue(*observer, *this);
@@ -120,7 +183,7 @@ void RTCDataChannel::OnStateChange() {
   }
   Dispatch(CreateCallback<RTCDataChannel>([this, state]() {
     RTCDataChannel::HandleStateChange(*this, state);
-  }));
+  }), PriorityOf(state));
 }
 
 void RTCDataChannel::HandleStateChange(RTCDataChannel& channel, webrtc::DataChannelInterface::DataState state) {
@@ -139,74 +202,596 @@ void RTCDataChannel::HandleStateChange(RTCDataChannel& channel, webrtc::DataChan
 }
 
 void RTCDataChannel::OnMessage(const webrtc::DataBuffer& buffer) {
-  Dispatch(CreateCallback<RTCDataChannel>([this, buffer]() {
+  if (!_framing && !_compressed) {
+    Receive(buffer);
+    return;
+  }
+  webrtc::DataBuffer message("");
+  if (Decode(_framing.get(), _compressed, _max_received_message_size.load(), buffer, &message)) {
+    Receive(message);
+  }
+}
+
+void RTCDataChannel::Receive(const webrtc::DataBuffer& buffer) {
+  _counters->DidReceive(buffer.size());
+  {
+    std::lock_guard<std::mutex> lock(_batch_lock);
+    // With a receive ring, JavaScript hears only that data is available, and
+    // only if it has not been told already.
+    if (_ring) {
+      if (_ring->Write(buffer.data.cdata(), buffer.size(), buffer.binary)) {
+        if (!_ring_notification_pending) {
+          _ring_notification_pending = true;
+          Dispatch(CreateCallback<RTCDataChannel>([this]() {
+            RTCDataChannel::HandleRingData(*this);
+          }), EventPriority::kBulk);
+        }
+        return;
+      }
+      _ring->DidDrop();
+      if (_ring_overflow == RingOverflow::kDrop) {
+        return;
+      }
+    }
+    // Messages are held in _batch while paused or batching, and behind any
+    // messages already held there, so that they are never reordered. Only the
+    // first message of a batch dispatches an Event; the rest join it until it
+    // runs.
+    if (_paused || _message_batching != MessageBatching::kNone || !_batch.empty()) {
+      // WebRTC cannot stop reading from SCTP, so while paused, at most
+      // _paused_limit bytes are held. Past that, messages are dropped, and
+      // JavaScript hears about it once per pause.
+      if (_paused && _paused_limit && _batch_bytes + buffer.size() > _paused_limit) {
+        if (!_paused_overflowed) {
+          _paused_overflowed = true;
+          Dispatch(CreateCallback<RTCDataChannel>([this]() {
+            RTCDataChannel::HandleReceiveOverflow(*this);
+          }));
+        }
+        return;
+      }
+      _batch.push_back(buffer);
+      _batch_bytes += buffer.size();
+      if (!_paused && !_batch_scheduled) {
+        ScheduleBatch();
+      }
+      return;
+    }
+  }
+  auto enqueued_at = uv_hrtime();
+  Dispatch(CreateCallback<RTCDataChannel>([this, buffer, enqueued_at]() {
+    _counters->DidQueue((uv_hrtime() - enqueued_at) / 1000);
     RTCDataChannel::HandleMessage(*this, buffer);
-  }));
+  }), EventPriority::kBulk);
 }
 
-void RTCDataChannel::HandleMessage(RTCDataChannel& channel, const webrtc::DataBuffer& buffer) {
-  bool binary = buffer.binary;
-  size_t size = buffer.size();
-  std::unique_ptr<char[]> message = std::unique_ptr<char[]>(new char[size]);
-  memcpy(reinterpret_cast<void*>(message.get()), reinterpret_cast<const void*>(buffer.data.data()), size);
+void RTCDataChannel::ScheduleBatch() {
+  _batch_scheduled = true;
+  _batch_scheduled_at = uv_hrtime();
+  Dispatch(CreateCallback<RTCDataChannel>([this]() {
+    RTCDataChannel::HandleMessages(*this);
+  }), EventPriority::kBulk);
+}
+
+void RTCDataChannel::OnBufferedAmountChange(uint64_t sent_data_size) {
+  // WebRTC reports the size of the message that just left the buffer, not the
+  // buffered amount before it did.
+  auto current_amount = _jingleDataChannel->buffered_amount();
+  auto previous_amount = current_amount + sent_data_size;
+  _counters->DidBuffer(previous_amount);
+  // This runs on the signaling thread, where buffered_amount does not need to
+  // hop threads, so JavaScript only hears about the crossings themselves.
+  auto queued = _compression_queued_bytes.load();
+  MaybeDispatchBufferedAmountLow(previous_amount + queued, current_amount + queued);
+}
+
+void RTCDataChannel::MaybeDispatchBufferedAmountLow(uint64_t previous_amount, uint64_t current_amount) {
+  auto threshold = _buffered_amount_low_threshold.load();
+  if (previous_amount > threshold && current_amount <= threshold) {
+    Dispatch(CreateCallback<RTCDataChannel>([this]() {
+      RTCDataChannel::HandleBufferedAmountLow(*this);
+    }));
+  }
+}
+
+void RTCDataChannel::HandleRingData(RTCDataChannel& channel) {
+  {
+    std::lock_guard<std::mutex> lock(channel._batch_lock);
+    channel._ring_notification_pending = false;
+  }
+  Nan::HandleScope scope;
+  channel.MakeCallback("onringdata", 0, nullptr);
+}
+
+void RTCDataChannel::HandleReceiveOverflow(RTCDataChannel& channel) {
+  Nan::HandleScope scope;
+  channel.MakeCallback("onreceiveoverflow", 0, nullptr);
+}
+
+void RTCDataChannel::HandleBufferedAmountLow(RTCDataChannel& channel) {
+  Nan::HandleScope scope;
+  channel.MakeCallback("onbufferedamountlow", 0, nullptr);
+}
+
+/**
+ * Text messages at least this large are delivered as external strings, when
+ * possible.
+ */
+static constexpr size_t kMinExternalStringLength = 16 * 1024;
+
+/**
+ * An ExternalOneByteString keeps a CopyOnWriteBuffer alive for as long as V8
+ * needs the string.
+ */
+class ExternalOneByteString: public v8::String::ExternalOneByteStringResource {
+ public:
+  explicit ExternalOneByteString(rtc::CopyOnWriteBuffer buffer): _buffer(std::move(buffer)) {}
+
+  const char* data() const override { return _buffer.cdata<char>(); }
+
+  size_t length() const override { return _buffer.size(); }
+
+ private:
+  rtc::CopyOnWriteBuffer _buffer;
+};
+
+static bool IsAscii(const uint8_t* data, size_t size) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if (word & UINT64_C(0x8080808080808080)) {
+      return false;
+    }
+  }
+  for (; i < size; i++) {
+    if (data[i] & 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
 
+static v8::Local<v8::String> CreateString(const rtc::CopyOnWriteBuffer& buffer) {
+  Nan::EscapableHandleScope scope;
+  auto data = buffer.cdata();
+  auto size = buffer.size();
+  if (!IsAscii(data, size)) {
+    return scope.Escape(Nan::New(reinterpret_cast<const char*>(data), size).ToLocalChecked());
+  }
+  // ASCII is valid Latin-1, so V8 can skip UTF-8 decoding altogether, and, for
+  // large messages, use the CopyOnWriteBuffer's storage directly.
+  if (size >= kMinExternalStringLength) {
+    auto resource = new ExternalOneByteString(buffer);
+    v8::Local<v8::String> string;
+    if (Nan::New<v8::String>(resource).ToLocal(&string)) {
+      return scope.Escape(string);
+    }
+    delete resource;
+  }
+  auto isolate = v8::Isolate::GetCurrent();
+  auto string = v8::String::NewFromOneByte(isolate, data, v8::NewStringType::kNormal, static_cast<int>(size));
+  return scope.Escape(string.ToLocalChecked());
+}
+
+/**
+ * Encode a string as UTF-8 directly into the CopyOnWriteBuffer of a
+ * DataBuffer.
+ */
+static webrtc::DataBuffer CreateDataBuffer(v8::Local<v8::String> string) {
+  auto isolate = v8::Isolate::GetCurrent();
+#if V8_MAJOR_VERSION >= 7
+  auto length = string->Utf8Length(isolate);
+#else
+  auto length = string->Utf8Length();
+#endif
+  rtc::CopyOnWriteBuffer buffer(static_cast<size_t>(length));
+  auto options = v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8;
+#if V8_MAJOR_VERSION >= 7
+  string->WriteUtf8(isolate, buffer.data<char>(), length, nullptr, options);
+#else
+  (void) isolate;
+  string->WriteUtf8(buffer.data<char>(), length, nullptr, options);
+#endif
+  return webrtc::DataBuffer(buffer, false);
+}
+
+static v8::Local<v8::Value> CreateMessage(const webrtc::DataBuffer& buffer) {
+  Nan::EscapableHandleScope scope;
+  if (buffer.binary) {
+    // The ArrayBuffer shares the CopyOnWriteBuffer's storage (and keeps it
+    // alive) rather than copying it. We use cdata, since data would make a
+    // private copy if anyone else still holds a reference.
+    auto data = const_cast<uint8_t*>(buffer.data.cdata());
+    return scope.Escape(ExternalArrayBuffer::New(data, buffer.size(), buffer.data));
+  }
+  return scope.Escape(CreateString(buffer.data));
+}
+
+void RTCDataChannel::HandleMessage(RTCDataChannel& channel, const webrtc::DataBuffer& buffer) {
   Nan::HandleScope scope;
   v8::Local<v8::Value> argv[1];
-  if (binary) {
-    v8::Local<v8::ArrayBuffer> array = v8::ArrayBuffer::New(
-            v8::Isolate::GetCurrent(),
-            message.release(),
-            size,
-            v8::ArrayBufferCreationMode::kInternalized);
-    argv[0] = array;
+  argv[0] = CreateMessage(buffer);
+  channel.MakeCallback("onmessage", 1, argv);
+}
+
+void RTCDataChannel::HandleMessages(RTCDataChannel& channel) {
+  std::vector<webrtc::DataBuffer> batch;
+  {
+    std::lock_guard<std::mutex> lock(channel._batch_lock);
+    channel._batch_scheduled = false;
+    if (channel._paused) {
+      // Resume schedules the batch again.
+      return;
+    }
+    batch.swap(channel._batch);
+    channel._batch_bytes = 0;
+    channel._counters->DidQueue((uv_hrtime() - channel._batch_scheduled_at) / 1000 * batch.size());
+  }
+
+  Nan::HandleScope scope;
+  switch (channel._message_batching.load()) {
+    case MessageBatching::kNone:
+      // These messages were held while paused (or batching was turned off after
+      // this batch started). If JavaScript pauses again part way through, hold
+      // the rest.
+      for (size_t i = 0; i < batch.size(); i++) {
+        if (channel._paused) {
+          std::lock_guard<std::mutex> lock(channel._batch_lock);
+          batch.erase(batch.begin(), batch.begin() + i);
+          for (auto const& buffer : batch) {
+            channel._batch_bytes += buffer.size();
+          }
+          batch.insert(batch.end(), channel._batch.begin(), channel._batch.end());
+          channel._batch.swap(batch);
+          return;
+        }
+        HandleMessage(channel, batch[i]);
+      }
+      break;
+    case MessageBatching::kArray: {
+      auto messages = Nan::New<v8::Array>(static_cast<int>(batch.size()));
+      for (uint32_t i = 0; i < batch.size(); i++) {
+        Nan::Set(messages, i, CreateMessage(batch[i]));
+      }
+      v8::Local<v8::Value> argv[1];
+      argv[0] = messages;
+      channel.MakeCallback("onmessages", 1, argv);
+      break;
+    }
+    case MessageBatching::kPacked: {
+      // Every message (text as UTF-8) is copied, back-to-back, into one
+      // ArrayBuffer, with its length in a parallel Uint32Array.
+      size_t total = 0;
+      for (auto const& buffer : batch) {
+        total += buffer.size();
+      }
+      auto isolate = v8::Isolate::GetCurrent();
+      auto packed = v8::ArrayBuffer::New(isolate, total);
+      auto lengths = v8::Uint32Array::New(v8::ArrayBuffer::New(isolate, batch.size() * sizeof(uint32_t)), 0, batch.size());
+      auto data = static_cast<uint8_t*>(packed->GetContents().Data());
+      auto sizes = static_cast<uint32_t*>(lengths->Buffer()->GetContents().Data());
+      for (auto const& buffer : batch) {
+        if (buffer.size()) {
+          memcpy(data, buffer.data.cdata(), buffer.size());
+        }
+        data += buffer.size();
+        *sizes++ = static_cast<uint32_t>(buffer.size());
+      }
+      v8::Local<v8::Value> argv[2];
+      argv[0] = packed;
+      argv[1] = lengths;
+      channel.MakeCallback("onmessages", 2, argv);
+      break;
+    }
+  }
+}
+
+/**
+ * Get the bytes of an ArrayBuffer or ArrayBufferView.
+ * @return false if the value is neither
+ */
+static bool GetBytes(v8::Local<v8::Value> value, const uint8_t** data, size_t* length) {
+  v8::Local<v8::ArrayBuffer> arraybuffer;
+  size_t byte_offset = 0;
+  size_t byte_length = 0;
+
+  if (value->IsArrayBufferView()) {
+    v8::Local<v8::ArrayBufferView> view = v8::Local<v8::ArrayBufferView>::Cast(value);
+    arraybuffer = view->Buffer();
+    byte_offset = view->ByteOffset();
+    byte_length = view->ByteLength();
+  } else if (value->IsArrayBuffer()) {
+    arraybuffer = v8::Local<v8::ArrayBuffer>::Cast(value);
+    byte_length = arraybuffer->ByteLength();
   } else {
-    v8::Local<v8::String> str = Nan::New(message.get(), size).ToLocalChecked();
-    argv[0] = str;
+    return false;
   }
-  channel.MakeCallback("onmessage", 1, argv);
+
+  v8::ArrayBuffer::Contents content = arraybuffer->GetContents();
+  *data = static_cast<const uint8_t*>(content.Data()) + byte_offset;
+  *length = byte_length;
+  return true;
+}
+
+/**
+ * Convert a string, ArrayBuffer or ArrayBufferView to a DataBuffer.
+ * @return false if the value is none of these
+ */
+static bool CreateDataBuffer(v8::Local<v8::Value> value, webrtc::DataBuffer* data_buffer) {
+  if (value->IsString()) {
+    *data_buffer = CreateDataBuffer(v8::Local<v8::String>::Cast(value));
+    return true;
+  }
+  const uint8_t* data;
+  size_t length;
+  if (!GetBytes(value, &data, &length)) {
+    return false;
+  }
+  *data_buffer = webrtc::DataBuffer(rtc::CopyOnWriteBuffer(data, length), true);
+  return true;
+}
+
+/**
+ * Send a message, in fragments if the RTCDataChannel uses DataChannelFraming.
+ * @return false if DataChannelInterface::Send rejected (any part of) it
+ */
+static bool SendMessage(webrtc::DataChannelInterface* channel, bool fragment, const webrtc::DataBuffer& message) {
+  if (!fragment) {
+    return channel->Send(message);
+  }
+  std::vector<webrtc::DataBuffer> fragments;
+  DataChannelFraming::Fragment(message, &fragments);
+  for (auto const& data_buffer : fragments) {
+    if (!channel->Send(data_buffer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RTCDataChannel::SendCompressed(const webrtc::DataBuffer& message) {
+  auto size = message.size();
+  _compression_queued_bytes += size;
+  auto channel = _jingleDataChannel;
+  auto fragment = _framing != nullptr;
+  _compression_invoker.AsyncInvoke<void>(RTC_FROM_HERE, DataChannelCompression::thread(), [this, channel, fragment, message, size]() {
+    // Like bytesReceived, bytesSent counts messages as JavaScript sees them,
+    // before compression.
+    auto compressed = DataChannelCompression::Compress(message, _compression_threshold.load());
+    _counters->DidSend(size, SendMessage(channel.get(), fragment, compressed));
+    auto buffered_amount = channel->buffered_amount();
+    _counters->DidBuffer(buffered_amount);
+    // Until now, the message counted towards bufferedAmount in full.
+    auto queued = _compression_queued_bytes.fetch_sub(size);
+    MaybeDispatchBufferedAmountLow(buffered_amount + queued, buffered_amount + queued - size);
+  });
+}
+
+/**
+ * Get the size of the largest message that can be fragmented. Compression adds
+ * a byte to messages it cannot shrink.
+ */
+static size_t MaxMessageSize(bool compressed) {
+  return DataChannelFraming::kMaxMessageSize - (compressed ? 1 : 0);
 }
 
 NAN_METHOD(RTCDataChannel::Send) {
   auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
 
-  if (self->_jingleDataChannel != nullptr) {
+  if (self->_jingleDataChannel == nullptr) {
+    return Nan::ThrowError(ErrorFactory::CreateInvalidStateError("RTCDataChannel.readyState is not 'open'"));
+  }
+
+  webrtc::DataBuffer data_buffer("");
+  if (!CreateDataBuffer(info[0], &data_buffer)) {
     if (self->_jingleDataChannel->state() != webrtc::DataChannelInterface::DataState::kOpen) {
       return Nan::ThrowError(ErrorFactory::CreateInvalidStateError("RTCDataChannel.readyState is not 'open'"));
     }
-    if (info[0]->IsString()) {
-      v8::Local<v8::String> str = v8::Local<v8::String>::Cast(info[0]);
-      std::string data = *v8::String::Utf8Value(str);
+    return Nan::ThrowTypeError("Expected a Blob or ArrayBuffer");
+  }
+  auto fragment = self->_framing != nullptr;
+  auto compressed = self->_compressed;
+  if (fragment && data_buffer.size() > MaxMessageSize(compressed)) {
+    return Nan::ThrowTypeError("Message is too large");
+  }
+
+  // Checking readyState, sending and reading bufferedAmount on the signaling
+  // thread costs one thread hop, rather than one for each through the proxy.
+  // Compressed messages are sent later, from the DataChannelCompression thread.
+  auto channel = self->_jingleDataChannel;
+  auto counters = self->_counters.get();
+  auto buffered_amount = self->_factory->_signalingThread->Invoke<Maybe<uint64_t>>(RTC_FROM_HERE, [channel, counters, fragment, compressed, &data_buffer]() {
+    if (channel->state() != webrtc::DataChannelInterface::DataState::kOpen) {
+      return Maybe<uint64_t>::Nothing();
+    }
+    if (!compressed) {
+      counters->DidSend(data_buffer.size(), SendMessage(channel.get(), fragment, data_buffer));
+    }
+    auto buffered_amount = channel->buffered_amount();
+    counters->DidBuffer(buffered_amount);
+    return Maybe<uint64_t>::Just(buffered_amount);
+  });
+  if (buffered_amount.IsNothing()) {
+    return Nan::ThrowError(ErrorFactory::CreateInvalidStateError("RTCDataChannel.readyState is not 'open'"));
+  }
+  if (compressed) {
+    self->SendCompressed(data_buffer);
+  }
+
+  // The bufferedAmount after sending, for createStream's backpressure.
+  info.GetReturnValue().Set(Nan::New<v8::Number>(buffered_amount.UnsafeFromJust() + self->_compression_queued_bytes.load()));
+}
+
+NAN_METHOD(RTCDataChannel::SendMany) {
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
+
+  if (self->_jingleDataChannel == nullptr) {
+    return Nan::ThrowError(ErrorFactory::CreateInvalidStateError("RTCDataChannel.readyState is not 'open'"));
+  }
 
-      webrtc::DataBuffer buffer(data);
-      self->_jingleDataChannel->Send(buffer);
+  // Build (and validate) every DataBuffer before sending any of them, so that
+  // invalid arguments never result in a partial send.
+  std::vector<webrtc::DataBuffer> data_buffers;
+  if (info[0]->IsArray()) {
+    auto array = v8::Local<v8::Array>::Cast(info[0]);
+    auto length = array->Length();
+    data_buffers.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+      data_buffers.emplace_back("");
+      if (!CreateDataBuffer(Nan::Get(array, i).ToLocalChecked(), &data_buffers.back())) {
+        return Nan::ThrowTypeError("Expected an Array of Blobs, ArrayBuffers or strings");
+      }
+    }
+  } else {
+    const uint8_t* data;
+    size_t length;
+    if (!GetBytes(info[0], &data, &length)) {
+      return Nan::ThrowTypeError("Expected an Array, or an ArrayBuffer and offsets");
+    }
+    std::vector<uint32_t> offsets;
+    if (info[1]->IsUint32Array()) {
+      auto view = v8::Local<v8::Uint32Array>::Cast(info[1]);
+      offsets.resize(view->Length());
+      view->CopyContents(offsets.data(), offsets.size() * sizeof(uint32_t));
     } else {
-      v8::Local<v8::ArrayBuffer> arraybuffer;
-      size_t byte_offset = 0;
-      size_t byte_length = 0;
-
-      if (info[0]->IsArrayBufferView()) {
-        v8::Local<v8::ArrayBufferView> view = v8::Local<v8::ArrayBufferView>::Cast(info[0]);
-        arraybuffer = view->Buffer();
-        byte_offset = view->ByteOffset();
-        byte_length = view->ByteLength();
-      } else if (info[0]->IsArrayBuffer()) {
-        arraybuffer = v8::Local<v8::ArrayBuffer>::Cast(info[0]);
-        byte_length = arraybuffer->ByteLength();
-      } else {
-        return Nan::ThrowTypeError("Expected a Blob or ArrayBuffer");
+      CONVERT_OR_THROW_AND_RETURN(info[1], maybe_offsets, std::vector<uint32_t>);
+      offsets = std::move(maybe_offsets);
+    }
+    // Message i spans from offsets[i] up to offsets[i + 1], or the end of the
+    // buffer.
+    data_buffers.reserve(offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++) {
+      size_t start = offsets[i];
+      size_t end = i + 1 < offsets.size() ? offsets[i + 1] : length;
+      if (start > end || end > length) {
+        return Nan::ThrowRangeError("Expected offsets to be ascending and within the buffer");
       }
+      data_buffers.emplace_back(rtc::CopyOnWriteBuffer(data + start, end - start), true);
+    }
+  }
 
-      v8::ArrayBuffer::Contents content = arraybuffer->GetContents();
-      rtc::CopyOnWriteBuffer buffer(
-          static_cast<char*>(content.Data()) + byte_offset,
-          byte_length);
+  auto fragment = self->_framing != nullptr;
+  if (fragment) {
+    for (auto const& data_buffer : data_buffers) {
+      if (data_buffer.size() > MaxMessageSize(self->_compressed)) {
+        return Nan::ThrowTypeError("Message is too large");
+      }
+    }
+  }
 
-      webrtc::DataBuffer data_buffer(buffer, true);
-      self->_jingleDataChannel->Send(data_buffer);
+  // As in Send, checking readyState, sending and reading bufferedAmount on the
+  // signaling thread costs one thread hop. Compressed messages are sent later,
+  // from the DataChannelCompression thread, so every one of them counts as
+  // accepted. Otherwise, sending stops once the channel closes or its send
+  // buffer fills up, at which point there is no use trying the rest.
+  auto channel = self->_jingleDataChannel;
+  auto counters = self->_counters.get();
+  auto compressed = self->_compressed;
+  auto accepted = self->_factory->_signalingThread->Invoke<Maybe<uint32_t>>(RTC_FROM_HERE, [channel, counters, fragment, compressed, &data_buffers]() {
+    if (channel->state() != webrtc::DataChannelInterface::DataState::kOpen) {
+      return Maybe<uint32_t>::Nothing();
     }
-  } else {
+    if (compressed) {
+      return Maybe<uint32_t>::Just(static_cast<uint32_t>(data_buffers.size()));
+    }
+    uint32_t accepted = 0;
+    for (auto const& data_buffer : data_buffers) {
+      auto sent = SendMessage(channel.get(), fragment, data_buffer);
+      counters->DidSend(data_buffer.size(), sent);
+      if (!sent) {
+        break;
+      }
+      accepted++;
+    }
+    counters->DidBuffer(channel->buffered_amount());
+    return Maybe<uint32_t>::Just(accepted);
+  });
+  if (accepted.IsNothing()) {
     return Nan::ThrowError(ErrorFactory::CreateInvalidStateError("RTCDataChannel.readyState is not 'open'"));
   }
+  if (compressed) {
+    for (auto const& data_buffer : data_buffers) {
+      self->SendCompressed(data_buffer);
+    }
+  }
+
+  info.GetReturnValue().Set(accepted.UnsafeFromJust());
+}
+
+NAN_METHOD(RTCDataChannel::Pause) {
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
+
+  CONVERT_ARGS_OR_THROW_AND_RETURN(maybeLimit, Maybe<uint32_t>)
+
+  std::lock_guard<std::mutex> lock(self->_batch_lock);
+  if (!self->_paused) {
+    self->_paused_overflowed = false;
+  }
+  self->_paused = true;
+  self->_paused_limit = maybeLimit.FromMaybe(kDefaultPausedLimit);
+}
+
+NAN_METHOD(RTCDataChannel::Resume) {
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
+
+  std::lock_guard<std::mutex> lock(self->_batch_lock);
+  self->_paused = false;
+  if (!self->_batch.empty() && !self->_batch_scheduled) {
+    self->ScheduleBatch();
+  }
+}
+
+NAN_METHOD(RTCDataChannel::SetReceiveRing) {
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
+
+  if (info[0]->IsNull() || info[0]->IsUndefined()) {
+    {
+      std::lock_guard<std::mutex> lock(self->_batch_lock);
+      self->_ring.reset();
+    }
+    self->_ring_buffer.Reset();
+    return;
+  }
+
+  if (!info[0]->IsSharedArrayBuffer()) {
+    return Nan::ThrowTypeError("Expected a SharedArrayBuffer");
+  }
+  auto buffer = v8::Local<v8::SharedArrayBuffer>::Cast(info[0]);
+  auto contents = buffer->GetContents();
+  if (contents.ByteLength() < SharedRingWriter::kHeaderSize + 8) {
+    return Nan::ThrowRangeError("Expected a SharedArrayBuffer of at least 24 bytes");
+  }
+
+  auto overflow = RingOverflow::kDrop;
+  if (!info[1]->IsUndefined()) {
+    CONVERT_OR_THROW_AND_RETURN(info[1], maybe_overflow, RingOverflow)
+    overflow = maybe_overflow;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(self->_batch_lock);
+    self->_ring.reset(new SharedRingWriter(contents.Data(), contents.ByteLength()));
+    self->_ring_overflow = overflow;
+  }
+  // The ring keeps a raw pointer into the SharedArrayBuffer, so hold on to it
+  // until the ring is replaced.
+  self->_ring_buffer.Reset(buffer);
+}
+
+NAN_METHOD(RTCDataChannel::GetCounters) {
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.This());
+  auto counters = self->_counters;
+
+  auto result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("messagesSent").ToLocalChecked(), Nan::New<v8::Number>(counters->messages_sent()));
+  Nan::Set(result, Nan::New("bytesSent").ToLocalChecked(), Nan::New<v8::Number>(counters->bytes_sent()));
+  Nan::Set(result, Nan::New("messagesReceived").ToLocalChecked(), Nan::New<v8::Number>(counters->messages_received()));
+  Nan::Set(result, Nan::New("bytesReceived").ToLocalChecked(), Nan::New<v8::Number>(counters->bytes_received()));
+  Nan::Set(result, Nan::New("sendFailures").ToLocalChecked(), Nan::New<v8::Number>(counters->send_failures()));
+  Nan::Set(result, Nan::New("peakBufferedAmount").ToLocalChecked(), Nan::New<v8::Number>(counters->peak_buffered_amount()));
+  Nan::Set(result, Nan::New("queuedTime").ToLocalChecked(), Nan::New<v8::Number>(counters->queued_time()));
+  info.GetReturnValue().Set(result);
 }
 
 NAN_METHOD(RTCDataChannel::Close) {
@@ -223,12 +808,69 @@ NAN_GETTER(RTCDataChannel::GetBufferedAmount) {
   auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
 
   uint64_t buffered_amount = self->_jingleDataChannel != nullptr
-      ? self->_jingleDataChannel->buffered_amount()
+      ? self->_jingleDataChannel->buffered_amount() + self->_compression_queued_bytes.load()
       : self->_cached_buffered_amount;
 
   info.GetReturnValue().Set(Nan::New<v8::Number>(buffered_amount));
 }
 
+NAN_GETTER(RTCDataChannel::GetBufferedAmountLowThreshold) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->_buffered_amount_low_threshold.load()));
+}
+
+NAN_SETTER(RTCDataChannel::SetBufferedAmountLowThreshold) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  CONVERT_OR_THROW_AND_RETURN(value, threshold, uint32_t)
+
+  self->_buffered_amount_low_threshold = threshold;
+}
+
+NAN_GETTER(RTCDataChannel::GetCompressionThreshold) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->_compression_threshold.load()));
+}
+
+NAN_SETTER(RTCDataChannel::SetCompressionThreshold) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  CONVERT_OR_THROW_AND_RETURN(value, threshold, uint32_t)
+
+  self->_compression_threshold = threshold;
+}
+
+NAN_GETTER(RTCDataChannel::GetMaxReceivedMessageSize) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->_max_received_message_size.load()));
+}
+
+NAN_SETTER(RTCDataChannel::SetMaxReceivedMessageSize) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  CONVERT_OR_THROW_AND_RETURN(value, max_message_size, uint32_t)
+
+  self->_max_received_message_size = max_message_size;
+  if (self->_framing) {
+    self->_framing->set_max_message_size(max_message_size);
+  }
+}
+
 NAN_GETTER(RTCDataChannel::GetId) {
   (void) property;
 
@@ -353,12 +995,32 @@ NAN_SETTER(RTCDataChannel::SetBinaryType) {
   self->_binaryType = binaryType;
 }
 
+NAN_GETTER(RTCDataChannel::GetMessageBatching) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  CONVERT_OR_THROW_AND_RETURN(self->_message_batching.load(), messageBatching, v8::Local<v8::Value>)
+
+  info.GetReturnValue().Set(messageBatching);
+}
+
+NAN_SETTER(RTCDataChannel::SetMessageBatching) {
+  (void) property;
+
+  auto self = AsyncObjectWrapWithLoop<RTCDataChannel>::Unwrap(info.Holder());
+
+  CONVERT_OR_THROW_AND_RETURN(value, messageBatching, MessageBatching)
+
+  self->_message_batching = messageBatching;
+}
+
 Wrap <
 RTCDataChannel*,
 rtc::scoped_refptr<webrtc::DataChannelInterface>,
 node_webrtc::DataChannelObserver*
 > * RTCDataChannel::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   RTCDataChannel*,
   rtc::scoped_refptr<webrtc::DataChannelInterface>,
   node_webrtc::DataChannelObserver*
@@ -381,9 +1043,15 @@ void RTCDataChannel::Init(v8::Handle<v8::Object> exports) {
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
   Nan::SetPrototypeMethod(tpl, "close", Close);
+  Nan::SetPrototypeMethod(tpl, "getCounters", GetCounters);
+  Nan::SetPrototypeMethod(tpl, "pause", Pause);
+  Nan::SetPrototypeMethod(tpl, "resume", Resume);
+  Nan::SetPrototypeMethod(tpl, "setReceiveRing", SetReceiveRing);
   Nan::SetPrototypeMethod(tpl, "send", Send);
+  Nan::SetPrototypeMethod(tpl, "sendMany", SendMany);
 
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("bufferedAmount").ToLocalChecked(), GetBufferedAmount, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("bufferedAmountLowThreshold").ToLocalChecked(), GetBufferedAmountLowThreshold, SetBufferedAmountLowThreshold);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("id").ToLocalChecked(), GetId, nullptr);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("label").ToLocalChecked(), GetLabel, nullptr);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("maxPacketLifeTime").ToLocalChecked(), GetMaxPacketLifeTime, nullptr);
@@ -394,6 +1062,9 @@ void RTCDataChannel::Init(v8::Handle<v8::Object> exports) {
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("protocol").ToLocalChecked(), GetProtocol, nullptr);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("binaryType").ToLocalChecked(), GetBinaryType, SetBinaryType);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("readyState").ToLocalChecked(), GetReadyState, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("messageBatching").ToLocalChecked(), GetMessageBatching, SetMessageBatching);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("compressionThreshold").ToLocalChecked(), GetCompressionThreshold, SetCompressionThreshold);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("maxReceivedMessageSize").ToLocalChecked(), GetMaxReceivedMessageSize, SetMaxReceivedMessageSize);
 
   constructor().Reset(tpl->GetFunction());
   exports->Set(Nan::New("RTCDataChannel").ToLocalChecked(), tpl->GetFunction());
@@ -7,24 +7,106 @@
  */
 #pragma once
 
+#include <atomic>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <nan.h>
 #include <webrtc/api/data_channel_interface.h>
 #include <webrtc/api/scoped_refptr.h>
+#include <webrtc/rtc_base/async_invoker.h>
 #include <v8.h>
 
 #include "src/enums/node_webrtc/binary_type.h"
+#include "src/enums/node_webrtc/message_batching.h"
+#include "src/enums/node_webrtc/ring_overflow.h"
 #include "src/node/async_object_wrap_with_loop.h"
 #include "src/node/event_queue.h"
 #include "src/node/wrap.h"
+#include "src/utilities/shared_ring.h"
+#include "src/webrtc/data_channel_compression.h"
+#include "src/webrtc/data_channel_framing.h"
 
 namespace node_webrtc {
 
 class DataChannelObserver;
 class PeerConnectionFactory;
 
+/**
+ * DataChannelCounters are lock-free throughput counters for one
+ * RTCDataChannel. Whichever thread does the work updates them, and JavaScript
+ * reads them without touching the signaling thread.
+ */
+class DataChannelCounters {
+ public:
+  /**
+   * Record a message passed to DataChannelInterface::Send.
+   * @param size the size of the message, in bytes
+   * @param accepted whether Send accepted it
+   */
+  void DidSend(size_t size, bool accepted) {
+    if (accepted) {
+      _messages_sent.fetch_add(1, std::memory_order_relaxed);
+      _bytes_sent.fetch_add(size, std::memory_order_relaxed);
+    } else {
+      _send_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Record an observed bufferedAmount.
+   * @param buffered_amount the bufferedAmount
+   */
+  void DidBuffer(uint64_t buffered_amount) {
+    auto peak = _peak_buffered_amount.load(std::memory_order_relaxed);
+    while (buffered_amount > peak && !_peak_buffered_amount.compare_exchange_weak(peak, buffered_amount, std::memory_order_relaxed)) {
+      // Do nothing.
+    }
+  }
+
+  /**
+   * Record a received (and reassembled) message.
+   * @param size the size of the message, in bytes
+   */
+  void DidReceive(size_t size) {
+    _messages_received.fetch_add(1, std::memory_order_relaxed);
+    _bytes_received.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  /**
+   * Record time messages spent queued before dispatch.
+   * @param time the time, in microseconds, summed over the messages
+   */
+  void DidQueue(uint64_t time) {
+    _queued_time.fetch_add(time, std::memory_order_relaxed);
+  }
+
+  uint64_t messages_sent() const { return _messages_sent.load(std::memory_order_relaxed); }
+
+  uint64_t bytes_sent() const { return _bytes_sent.load(std::memory_order_relaxed); }
+
+  uint64_t messages_received() const { return _messages_received.load(std::memory_order_relaxed); }
+
+  uint64_t bytes_received() const { return _bytes_received.load(std::memory_order_relaxed); }
+
+  uint64_t send_failures() const { return _send_failures.load(std::memory_order_relaxed); }
+
+  uint64_t peak_buffered_amount() const { return _peak_buffered_amount.load(std::memory_order_relaxed); }
+
+  uint64_t queued_time() const { return _queued_time.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> _messages_sent = {0};
+  std::atomic<uint64_t> _bytes_sent = {0};
+  std::atomic<uint64_t> _messages_received = {0};
+  std::atomic<uint64_t> _bytes_received = {0};
+  std::atomic<uint64_t> _send_failures = {0};
+  std::atomic<uint64_t> _peak_buffered_amount = {0};
+  std::atomic<uint64_t> _queued_time = {0};
+};
+
 class RTCDataChannel
   : public AsyncObjectWrapWithLoop<RTCDataChannel>
   , public webrtc::DataChannelObserver {
@@ -38,6 +120,11 @@ class RTCDataChannel
 
   ~RTCDataChannel() override;
 
+  /**
+   * The number of bytes held while paused, unless pause is given a limit.
+   */
+  static constexpr uint32_t kDefaultPausedLimit = 16 * 1024 * 1024;
+
   static void Init(v8::Handle<v8::Object> exports);
 
   //
@@ -45,6 +132,7 @@ class RTCDataChannel
   //
   void OnStateChange() override;
   void OnMessage(const webrtc::DataBuffer& buffer) override;
+  void OnBufferedAmountChange(uint64_t sent_data_size) override;
 
   void OnPeerConnectionClosed();
 
@@ -65,16 +153,28 @@ class RTCDataChannel
 
   static void HandleStateChange(RTCDataChannel&, webrtc::DataChannelInterface::DataState);
   static void HandleMessage(RTCDataChannel&, const webrtc::DataBuffer& buffer);
+  static void HandleMessages(RTCDataChannel&);
+  static void HandleBufferedAmountLow(RTCDataChannel&);
+  static void HandleReceiveOverflow(RTCDataChannel&);
+  static void HandleRingData(RTCDataChannel&);
 
   static NAN_METHOD(New);
 
   static NAN_METHOD(Send);
+  static NAN_METHOD(SendMany);
   static NAN_METHOD(Close);
+  static NAN_METHOD(GetCounters);
+  static NAN_METHOD(Pause);
+  static NAN_METHOD(Resume);
+  static NAN_METHOD(SetReceiveRing);
 
   static NAN_GETTER(GetBufferedAmount);
+  static NAN_GETTER(GetBufferedAmountLowThreshold);
+  static NAN_GETTER(GetCompressionThreshold);
   static NAN_GETTER(GetId);
   static NAN_GETTER(GetLabel);
   static NAN_GETTER(GetMaxPacketLifeTime);
+  static NAN_GETTER(GetMaxReceivedMessageSize);
   static NAN_GETTER(GetMaxRetransmits);
   static NAN_GETTER(GetNegotiated);
   static NAN_GETTER(GetOrdered);
@@ -82,11 +182,59 @@ class RTCDataChannel
   static NAN_GETTER(GetProtocol);
   static NAN_GETTER(GetBinaryType);
   static NAN_GETTER(GetReadyState);
+  static NAN_GETTER(GetMessageBatching);
+  static NAN_SETTER(SetBufferedAmountLowThreshold);
+  static NAN_SETTER(SetCompressionThreshold);
+  static NAN_SETTER(SetMaxReceivedMessageSize);
   static NAN_SETTER(SetBinaryType);
+  static NAN_SETTER(SetMessageBatching);
 
   void CleanupInternals();
 
+  /**
+   * Deliver a (reassembled) message.
+   */
+  void Receive(const webrtc::DataBuffer& buffer);
+
+  /**
+   * Dispatch an Event to deliver _batch. _batch_lock must be held.
+   */
+  void ScheduleBatch();
+
+  /**
+   * Compress and send a message on the DataChannelCompression thread. Every
+   * message sent on a compressed RTCDataChannel goes through here, so that they
+   * stay in order.
+   */
+  void SendCompressed(const webrtc::DataBuffer& message);
+
+  /**
+   * Dispatch an Event for bufferedamountlow if the bufferedAmount (including
+   * messages waiting to be compressed) crossed the threshold.
+   */
+  void MaybeDispatchBufferedAmountLow(uint64_t previous_amount, uint64_t current_amount);
+
   BinaryType _binaryType;
+  std::atomic<MessageBatching> _message_batching;
+  std::atomic<uint64_t> _buffered_amount_low_threshold;
+  std::mutex _batch_lock;
+  std::vector<webrtc::DataBuffer> _batch;
+  bool _batch_scheduled = false;
+  uint64_t _batch_scheduled_at = 0;
+  bool _paused = false;
+  size_t _batch_bytes = 0;
+  size_t _paused_limit = 0;
+  bool _paused_overflowed = false;
+  std::unique_ptr<SharedRingWriter> _ring;
+  RingOverflow _ring_overflow = RingOverflow::kDrop;
+  bool _ring_notification_pending = false;
+  Nan::Global<v8::SharedArrayBuffer> _ring_buffer;
+  std::unique_ptr<DataChannelFraming> _framing;
+  bool _compressed = false;
+  std::atomic<uint64_t> _compression_threshold = {DataChannelCompression::kDefaultThreshold};
+  std::atomic<uint64_t> _compression_queued_bytes = {0};
+  std::atomic<uint64_t> _max_received_message_size = {DataChannelFraming::kMaxMessageSize};
+  std::shared_ptr<DataChannelCounters> _counters;
   int _cached_id;
   std::string _cached_label;
   uint16_t _cached_max_packet_life_time;
@@ -97,6 +245,10 @@ class RTCDataChannel
   uint64_t _cached_buffered_amount;
   std::shared_ptr<PeerConnectionFactory> _factory;
   rtc::scoped_refptr<webrtc::DataChannelInterface> _jingleDataChannel;
+
+  // Destroyed first, so that it cancels (or waits for) SendCompressed's tasks
+  // before the members they use go away.
+  rtc::AsyncInvoker _compression_invoker;
 };
 
 class DataChannelObserver
@@ -115,6 +267,9 @@ class DataChannelObserver
  private:
   std::shared_ptr<PeerConnectionFactory> _factory;
   rtc::scoped_refptr<webrtc::DataChannelInterface> _jingleDataChannel;
+  std::unique_ptr<DataChannelFraming> _framing;
+  bool _compressed;
+  std::shared_ptr<DataChannelCounters> _counters;
 };
 
 }  // namespace node_webrtc
@@ -26,12 +26,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCDtlsTransport::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& RTCDtlsTransport::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -116,7 +116,7 @@ RTCDtlsTransport*,
 rtc::scoped_refptr<webrtc::DtlsTransportInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * RTCDtlsTransport::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   RTCDtlsTransport*,
   rtc::scoped_refptr<webrtc::DtlsTransportInterface>,
   std::shared_ptr<PeerConnectionFactory>
@@ -55,7 +55,7 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCPeerConnection::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
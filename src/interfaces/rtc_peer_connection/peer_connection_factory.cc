@@ -8,8 +8,8 @@
 #include "peer_connection_factory.h"
 
 #include <memory>
+#include <mutex>
 
-#include <uv.h>
 #include <webrtc/api/audio_codecs/builtin_audio_decoder_factory.h>
 #include <webrtc/api/audio_codecs/builtin_audio_encoder_factory.h>
 #include <webrtc/api/create_peerconnection_factory.h>
@@ -31,13 +31,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& PeerConnectionFactory::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
-std::shared_ptr<PeerConnectionFactory> PeerConnectionFactory::_default;  // NOLINT
-uv_mutex_t PeerConnectionFactory::_lock;  // NOLINT
-int PeerConnectionFactory::_references = 0;
+thread_local std::shared_ptr<PeerConnectionFactory> PeerConnectionFactory::_default;  // NOLINT
+thread_local int PeerConnectionFactory::_references = 0;
 
 PeerConnectionFactory::PeerConnectionFactory(Maybe<webrtc::AudioDeviceModule::AudioLayer> audioLayer) {
   _workerThread = std::make_unique<rtc::Thread>();
@@ -109,38 +108,34 @@ NAN_METHOD(PeerConnectionFactory::New) {
 }
 
 std::shared_ptr<PeerConnectionFactory> PeerConnectionFactory::GetOrCreateDefault() {
-  uv_mutex_lock(&_lock);
   _references++;
   if (_references == 1) {
     _default = std::make_shared<PeerConnectionFactory>();
   }
-  uv_mutex_unlock(&_lock);
   return _default;
 }
 
 void PeerConnectionFactory::Release() {
-  uv_mutex_lock(&_lock);
   _references--;
   assert(_references >= 0);
   if (!_references) {
     _default = nullptr;
   }
-  uv_mutex_unlock(&_lock);
 }
 
 void PeerConnectionFactory::Dispose() {
-  uv_mutex_destroy(&_lock);
   rtc::CleanupSSL();
 }
 
 void PeerConnectionFactory::Init(v8::Handle<v8::Object> exports) {
-  uv_mutex_init(&_lock);
+  static std::once_flag initialized;
+  std::call_once(initialized, []() {
+    bool result;
+    (void) result;
 
-  bool result;
-  (void) result;
-
-  result = rtc::InitializeSSL();
-  assert(result);
+    result = rtc::InitializeSSL();
+    assert(result);
+  });
 
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
   tpl->SetClassName(Nan::New("PeerConnectionFactory").ToLocalChecked());
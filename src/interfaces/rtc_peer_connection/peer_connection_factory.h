@@ -10,7 +10,6 @@
 #include <memory>
 
 #include <nan.h>
-#include <uv.h>
 #include <webrtc/api/scoped_refptr.h>
 #include <webrtc/modules/audio_device/include/audio_device.h>
 #include <v8.h>
@@ -47,6 +46,8 @@ class PeerConnectionFactory
   /**
    * Get or create the default PeerConnectionFactory. The default uses
    * webrtc::AudioDeviceModule::AudioLayer::kDummyAudio. Call {@link Release} when done.
+   * Each JavaScript thread (main or worker) has its own default, so that each
+   * worker gets its own signaling and worker threads.
    */
   static std::shared_ptr<PeerConnectionFactory> GetOrCreateDefault();
 
@@ -79,9 +80,8 @@ class PeerConnectionFactory
 
   static NAN_METHOD(New);
 
-  static std::shared_ptr<PeerConnectionFactory> _default;
-  static uv_mutex_t _lock;
-  static int _references;
+  static thread_local std::shared_ptr<PeerConnectionFactory> _default;
+  static thread_local int _references;
 
   rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> _factory;
   rtc::scoped_refptr<webrtc::AudioDeviceModule> _audioDeviceModule;
@@ -21,12 +21,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCRtpReceiver::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& RTCRtpReceiver::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -127,7 +127,7 @@ RTCRtpReceiver*,
 rtc::scoped_refptr<webrtc::RtpReceiverInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * RTCRtpReceiver::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   RTCRtpReceiver*,
   rtc::scoped_refptr<webrtc::RtpReceiverInterface>,
   std::shared_ptr<PeerConnectionFactory>
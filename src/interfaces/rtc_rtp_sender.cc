@@ -19,12 +19,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCRtpSender::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& RTCRtpSender::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -123,7 +123,7 @@ RTCRtpSender*,
 rtc::scoped_refptr<webrtc::RtpSenderInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * RTCRtpSender::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   RTCRtpSender*,
   rtc::scoped_refptr<webrtc::RtpSenderInterface>,
   std::shared_ptr<PeerConnectionFactory>
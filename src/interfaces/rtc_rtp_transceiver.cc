@@ -20,12 +20,12 @@
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCRtpTransceiver::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
 Nan::Persistent<v8::FunctionTemplate>& RTCRtpTransceiver::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
@@ -123,7 +123,7 @@ RTCRtpTransceiver*,
 rtc::scoped_refptr<webrtc::RtpTransceiverInterface>,
 std::shared_ptr<PeerConnectionFactory>
 > * RTCRtpTransceiver::wrap() {
-  static auto wrap = new node_webrtc::Wrap <
+  static thread_local auto wrap = new node_webrtc::Wrap <
   RTCRtpTransceiver*,
   rtc::scoped_refptr<webrtc::RtpTransceiverInterface>,
   std::shared_ptr<PeerConnectionFactory>
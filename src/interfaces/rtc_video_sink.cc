@@ -7,30 +7,65 @@
  */
 #include "src/interfaces/rtc_video_sink.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
+#include <libyuv.h>
 #include <v8.h>
 #include <webrtc/api/video/video_frame.h>
 #include <webrtc/api/video/video_source_interface.h>
+#include <webrtc/rtc_base/time_utils.h>
 
 #include "src/converters.h"
 #include "src/converters/arguments.h"
+#include "src/converters/v8.h"  // IWYU pragma: keep
 #include "src/dictionaries/webrtc/video_frame.h"  // IWYU pragma: keep
+#include "src/functional/maybe.h"
 #include "src/functional/validation.h"
 #include "src/interfaces/media_stream_track.h"  // IWYU pragma: keep
 #include "src/node/events.h"
+#include "src/webrtc/converted_video_frame_buffer.h"
+#include "src/webrtc/frame_buffer_pool.h"
 
 namespace node_webrtc {
 
 Nan::Persistent<v8::FunctionTemplate>& RTCVideoSink::tpl() {
-  static Nan::Persistent<v8::FunctionTemplate> tpl;
+  static thread_local Nan::Persistent<v8::FunctionTemplate> tpl;
   return tpl;
 }
 
-RTCVideoSink::RTCVideoSink(rtc::scoped_refptr<webrtc::VideoTrackInterface> track)
-  : AsyncObjectWrapWithLoop<RTCVideoSink>("RTCVideoSink", *this)
-  , _track(std::move(track)) {
+/**
+ * Get the time between frames, in microseconds, capped at an hour.
+ */
+static int64_t FrameInterval(double fps) {
+  return static_cast<int64_t>(std::min(rtc::kNumMicrosecsPerSec / fps, 3600.0 * rtc::kNumMicrosecsPerSec));
+}
+
+RTCVideoSink::RTCVideoSink(rtc::scoped_refptr<webrtc::VideoTrackInterface> track, const RTCVideoSinkInit& init)
+  : AsyncObjectWrapWithLoop<RTCVideoSink>("RTCVideoSink", *this, OverflowPolicy::kDropOldest)
+  , _track(std::move(track))
+  , _frame_interval(init.maxFramerate.Map(FrameInterval).FromMaybe(0))
+  , _max_pixel_count(static_cast<int>(std::min<uint32_t>(init.maxPixelCount.FromMaybe(0), INT_MAX)))
+  , _scale_width(init.scaleResolutionTo.Map([](auto resolution) { return static_cast<int>(resolution.width); }).FromMaybe(0))
+  , _scale_height(init.scaleResolutionTo.Map([](auto resolution) { return static_cast<int>(resolution.height); }).FromMaybe(0))
+  , _format(init.format)
+  , _coalesce(init.coalesce) {
+  // Sources that respect VideoSinkWants adapt upstream; the rest are scaled
+  // and rate-limited here.
   rtc::VideoSinkWants wants;
+  if (_max_pixel_count) {
+    wants.max_pixel_count = _max_pixel_count;
+  }
+  if (_scale_width) {
+    wants.target_pixel_count = _scale_width * _scale_height;
+  }
+  if (init.maxFramerate.IsJust()) {
+    wants.max_framerate_fps = static_cast<int>(std::min(std::ceil(init.maxFramerate.UnsafeFromJust()), static_cast<double>(INT_MAX)));
+  }
   _track->AddOrUpdateSink(this, wants);
 }
 
@@ -38,8 +73,10 @@ NAN_METHOD(RTCVideoSink::New) {
   if (!info.IsConstructCall()) {
     return Nan::ThrowTypeError("Use the new operator to construct an RTCVideoSink.");
   }
-  CONVERT_ARGS_OR_THROW_AND_RETURN(track, rtc::scoped_refptr<webrtc::VideoTrackInterface>)
-  auto sink = new RTCVideoSink(track);
+  CONVERT_ARGS_OR_THROW_AND_RETURN(args, std::tuple<rtc::scoped_refptr<webrtc::VideoTrackInterface> COMMA Maybe<RTCVideoSinkInit>>)
+  auto track = std::get<0>(args);
+  auto init = std::get<1>(args).FromMaybe(RTCVideoSinkInit());
+  auto sink = new RTCVideoSink(track, init);
   sink->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
 }
@@ -50,6 +87,26 @@ NAN_GETTER(RTCVideoSink::GetStopped) {
   info.GetReturnValue().Set(self->_stopped);
 }
 
+NAN_GETTER(RTCVideoSink::GetFramesDropped) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCVideoSink>::Unwrap(info.Holder());
+  auto dropped = self->dropped() + self->_frames_coalesced.load();
+  info.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(dropped)));
+}
+
+NAN_GETTER(RTCVideoSink::GetHighWaterMark) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCVideoSink>::Unwrap(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->high_water_mark()));
+}
+
+NAN_SETTER(RTCVideoSink::SetHighWaterMark) {
+  (void) property;
+  auto self = AsyncObjectWrapWithLoop<RTCVideoSink>::Unwrap(info.Holder());
+  CONVERT_OR_THROW_AND_RETURN(value, highWaterMark, uint32_t)
+  self->set_high_water_mark(highWaterMark);
+}
+
 void RTCVideoSink::Stop() {
   if (_track) {
     _stopped = true;
@@ -65,18 +122,105 @@ NAN_METHOD(RTCVideoSink::JsStop) {
 }
 
 void RTCVideoSink::OnFrame(const webrtc::VideoFrame& frame) {
-  Dispatch(CreateCallback<RTCVideoSink>([this, frame]() {
-    Nan::HandleScope scope;
-    auto maybeValue = From<v8::Local<v8::Value>>(frame);
-    if (maybeValue.IsInvalid()) {
-      // TODO(mroberts): Should raise an error; although this really shouldn't happen.
+  // Frames are due every _frame_interval, give or take a quarter of one for
+  // jitter; after a gap, the schedule restarts.
+  if (_frame_interval) {
+    auto now = rtc::TimeMicros();
+    if (now < _next_frame_at - _frame_interval / 4) {
       return;
     }
-    auto value = maybeValue.UnsafeFromValid();
-    v8::Local<v8::Value> argv[1];
-    argv[0] = value;
-    MakeCallback("onframe", 1, argv);
-  }));
+    _next_frame_at = now - _next_frame_at > _frame_interval
+        ? now + _frame_interval
+        : _next_frame_at + _frame_interval;
+  }
+
+  auto buffer = frame.video_frame_buffer();
+  auto width = buffer->width();
+  auto height = buffer->height();
+  if (_scale_width) {
+    width = _scale_width;
+    height = _scale_height;
+  } else if (_max_pixel_count && width * height > _max_pixel_count) {
+    auto scale = std::sqrt(static_cast<double>(_max_pixel_count) / (width * height));
+    width = std::max(2, static_cast<int>(width * scale) & ~1);
+    height = std::max(2, static_cast<int>(height * scale) & ~1);
+  }
+  if (width != buffer->width() || height != buffer->height()) {
+    auto source = buffer->ToI420();
+    auto scaled = PooledI420Buffer::Create(width, height);
+    libyuv::I420Scale(
+        source->DataY(), source->StrideY(),
+        source->DataU(), source->StrideU(),
+        source->DataV(), source->StrideV(),
+        source->width(), source->height(),
+        scaled->MutableDataY(), scaled->StrideY(),
+        scaled->MutableDataU(), scaled->StrideU(),
+        scaled->MutableDataV(), scaled->StrideV(),
+        width, height,
+        libyuv::kFilterBox);
+    buffer = scaled;
+  }
+  // Converting here, too, keeps color conversion off the JavaScript thread.
+  if (_format != VideoFrameFormat::kI420) {
+    buffer = ConvertedVideoFrameBuffer::Create(*buffer->ToI420(), _format);
+  }
+  if (buffer == frame.video_frame_buffer()) {
+    Deliver(frame);
+    return;
+  }
+
+  Deliver(webrtc::VideoFrame::Builder()
+      .set_video_frame_buffer(buffer)
+      .set_timestamp_us(frame.timestamp_us())
+      .set_timestamp_rtp(frame.timestamp())
+      .set_rotation(frame.rotation())
+      .build());
+}
+
+void RTCVideoSink::Deliver(const webrtc::VideoFrame& frame) {
+  if (_coalesce) {
+    std::lock_guard<std::mutex> lock(_pending_frame_lock);
+    // Replacing an undelivered frame releases it right away. Only the first
+    // pending frame dispatches an Event; it delivers whichever frame is newest
+    // when it runs.
+    auto pending = _pending_frame.has_value();
+    _pending_frame = frame;
+    if (pending) {
+      _frames_coalesced++;
+      return;
+    }
+    Dispatch(CreateCallback<RTCVideoSink>([this]() {
+      RTCVideoSink::HandlePendingFrame(*this);
+    }), EventPriority::kBulk);
+    return;
+  }
+  Dispatch(CreateCallback<RTCVideoSink>([this, frame]() {
+    RTCVideoSink::HandleFrame(*this, frame);
+  }), EventPriority::kBulk);
+}
+
+void RTCVideoSink::HandlePendingFrame(RTCVideoSink& sink) {
+  absl::optional<webrtc::VideoFrame> frame;
+  {
+    std::lock_guard<std::mutex> lock(sink._pending_frame_lock);
+    std::swap(frame, sink._pending_frame);
+  }
+  if (frame) {
+    HandleFrame(sink, *frame);
+  }
+}
+
+void RTCVideoSink::HandleFrame(RTCVideoSink& sink, const webrtc::VideoFrame& frame) {
+  Nan::HandleScope scope;
+  auto maybeValue = From<v8::Local<v8::Value>>(std::make_pair(frame, sink._format));
+  if (maybeValue.IsInvalid()) {
+    // TODO(mroberts): Should raise an error; although this really shouldn't happen.
+    return;
+  }
+  auto value = maybeValue.UnsafeFromValid();
+  v8::Local<v8::Value> argv[1];
+  argv[0] = value;
+  sink.MakeCallback("onframe", 1, argv);
 }
 
 void RTCVideoSink::Init(v8::Handle<v8::Object> exports) {
@@ -85,6 +229,8 @@ void RTCVideoSink::Init(v8::Handle<v8::Object> exports) {
   tpl->SetClassName(Nan::New("RTCVideoSink").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
   Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("stopped").ToLocalChecked(), GetStopped, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("framesDropped").ToLocalChecked(), GetFramesDropped, nullptr);
+  Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("highWaterMark").ToLocalChecked(), GetHighWaterMark, SetHighWaterMark);
   Nan::SetPrototypeMethod(tpl, "stop", JsStop);
   exports->Set(Nan::New("RTCVideoSink").ToLocalChecked(), tpl->GetFunction());
 }
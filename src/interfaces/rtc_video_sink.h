@@ -7,17 +7,23 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <absl/types/optional.h>
 #include <nan.h>
 #include <webrtc/api/media_stream_interface.h>
 #include <webrtc/api/scoped_refptr.h>
+#include <webrtc/api/video/video_frame.h>
 #include <webrtc/api/video/video_sink_interface.h>
 
+#include "src/dictionaries/node_webrtc/rtc_video_sink_init.h"
 #include "src/node/async_object_wrap_with_loop.h"
 
 namespace v8 { class FunctionTemplate; }
 namespace v8 { class Object; }
 namespace v8 { template <class T> class Local; }
-namespace webrtc { class VideoFrame; }
 
 namespace node_webrtc {
 
@@ -35,18 +41,49 @@ class RTCVideoSink
   void Stop() override;
 
  private:
-  explicit RTCVideoSink(rtc::scoped_refptr<webrtc::VideoTrackInterface>);
+  RTCVideoSink(rtc::scoped_refptr<webrtc::VideoTrackInterface>, const RTCVideoSinkInit&);
 
   static Nan::Persistent<v8::FunctionTemplate>& tpl();
 
+  static void HandleFrame(RTCVideoSink&, const webrtc::VideoFrame&);
+
+  static void HandlePendingFrame(RTCVideoSink&);
+
+  /**
+   * Queue a (rate-limited, scaled and converted) frame for JavaScript.
+   */
+  void Deliver(const webrtc::VideoFrame&);
+
   static NAN_METHOD(New);
 
   static NAN_GETTER(GetStopped);
 
+  static NAN_GETTER(GetFramesDropped);
+
+  static NAN_GETTER(GetHighWaterMark);
+
+  static NAN_SETTER(SetHighWaterMark);
+
   static NAN_METHOD(JsStop);
 
   bool _stopped = false;
   rtc::scoped_refptr<webrtc::VideoTrackInterface> _track;
+
+  // Frames are rate-limited, scaled and converted before they are queued. OnFrame is never
+  // called concurrently, so _next_frame_at needs no lock.
+  const int64_t _frame_interval;
+  const int _max_pixel_count;
+  const int _scale_width;
+  const int _scale_height;
+  const VideoFrameFormat _format;
+  int64_t _next_frame_at = 0;
+
+  // With coalescing, at most one frame waits for JavaScript at a time; newer
+  // frames replace it.
+  const bool _coalesce;
+  std::mutex _pending_frame_lock;
+  absl::optional<webrtc::VideoFrame> _pending_frame;
+  std::atomic<uint64_t> _frames_coalesced = {0};
 };
 
 }  // namespace node_webrtc
@@ -8,7 +8,6 @@
 #include "src/interfaces/rtc_video_source.h"
 
 #include <webrtc/api/peer_connection_interface.h>
-#include <webrtc/api/video/i420_buffer.h>
 #include <webrtc/api/video/video_frame.h>
 #include <webrtc/rtc_base/ref_counted_object.h>
 
@@ -19,11 +18,12 @@
 #include "src/dictionaries/webrtc/video_frame_buffer.h"
 #include "src/functional/maybe.h"
 #include "src/interfaces/media_stream_track.h"
+#include "src/webrtc/frame_buffer_pool.h"
 
 namespace node_webrtc {
 
 Nan::Persistent<v8::Function>& RTCVideoSource::constructor() {
-  static Nan::Persistent<v8::Function> constructor;
+  static thread_local Nan::Persistent<v8::Function> constructor;
   return constructor;
 }
 
@@ -65,7 +65,7 @@ NAN_METHOD(RTCVideoSource::CreateTrack) {
 
 NAN_METHOD(RTCVideoSource::OnFrame) {
   auto self = Nan::ObjectWrap::Unwrap<RTCVideoSource>(info.Holder());
-  CONVERT_ARGS_OR_THROW_AND_RETURN(buffer, rtc::scoped_refptr<webrtc::I420Buffer>)
+  CONVERT_ARGS_OR_THROW_AND_RETURN(buffer, rtc::scoped_refptr<PooledI420Buffer>)
   webrtc::VideoFrame::Builder builder;
   auto frame = builder.set_video_frame_buffer(buffer).build();
   self->_source->PushFrame(frame);
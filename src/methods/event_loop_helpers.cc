@@ -0,0 +1,87 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/methods/event_loop_helpers.h"
+
+#include "src/converters.h"
+#include "src/converters/arguments.h"
+#include "src/converters/v8.h"
+#include "src/dictionaries/node_webrtc/event_loop_budget.h"
+#include "src/functional/maybe.h"
+#include "src/node/event_dispatcher.h"
+#include "src/node/event_loop_metrics.h"
+
+namespace node_webrtc {
+
+NAN_METHOD(EventLoopHelpers::GetEventLoopBudget) {
+  auto& dispatcher = EventDispatcher::Current();
+  EventLoopBudget budget = {
+    MakeJust(dispatcher.max_events()),
+    MakeJust(dispatcher.max_time())
+  };
+  CONVERT_OR_THROW_AND_RETURN(budget, result, v8::Local<v8::Value>)
+  info.GetReturnValue().Set(result);
+}
+
+static v8::Local<v8::Object> LatencyToObject(const LatencyHistogram& latency) {
+  Nan::EscapableHandleScope scope;
+  auto object = Nan::New<v8::Object>();
+  Nan::Set(object, Nan::New("count").ToLocalChecked(), Nan::New<v8::Number>(latency.count()));
+  Nan::Set(object, Nan::New("min").ToLocalChecked(), Nan::New<v8::Number>(latency.min()));
+  Nan::Set(object, Nan::New("max").ToLocalChecked(), Nan::New<v8::Number>(latency.max()));
+  Nan::Set(object, Nan::New("mean").ToLocalChecked(), Nan::New<v8::Number>(latency.mean()));
+  Nan::Set(object, Nan::New("p50").ToLocalChecked(), Nan::New<v8::Number>(latency.Percentile(50)));
+  Nan::Set(object, Nan::New("p90").ToLocalChecked(), Nan::New<v8::Number>(latency.Percentile(90)));
+  Nan::Set(object, Nan::New("p99").ToLocalChecked(), Nan::New<v8::Number>(latency.Percentile(99)));
+  Nan::Set(object, Nan::New("p999").ToLocalChecked(), Nan::New<v8::Number>(latency.Percentile(99.9)));
+  return scope.Escape(object);
+}
+
+NAN_METHOD(EventLoopHelpers::GetEventLoopMetrics) {
+  auto result = Nan::New<v8::Object>();
+  for (auto const& pair : EventLoopMetrics::All()) {
+    auto metrics = pair.second;
+    auto object = Nan::New<v8::Object>();
+    Nan::Set(object, Nan::New("queueDepth").ToLocalChecked(), Nan::New<v8::Number>(metrics->depth()));
+    Nan::Set(object, Nan::New("peakQueueDepth").ToLocalChecked(), Nan::New<v8::Number>(metrics->peak_depth()));
+    Nan::Set(object, Nan::New("eventsDispatched").ToLocalChecked(), Nan::New<v8::Number>(metrics->dispatched()));
+    Nan::Set(object, Nan::New("eventsDropped").ToLocalChecked(), Nan::New<v8::Number>(metrics->dropped()));
+    Nan::Set(object, Nan::New("latency").ToLocalChecked(), LatencyToObject(metrics->latency()));
+    Nan::Set(result, Nan::New(pair.first).ToLocalChecked(), object);
+  }
+  info.GetReturnValue().Set(result);
+}
+
+NAN_METHOD(EventLoopHelpers::GetFastCallbacks) {
+  info.GetReturnValue().Set(Nan::New(EventDispatcher::Current().fast_callbacks()));
+}
+
+NAN_METHOD(EventLoopHelpers::SetEventLoopBudget) {
+  CONVERT_ARGS_OR_THROW_AND_RETURN(budget, EventLoopBudget)
+  auto& dispatcher = EventDispatcher::Current();
+  if (budget.maxEvents.IsJust()) {
+    dispatcher.set_max_events(budget.maxEvents.UnsafeFromJust());
+  }
+  if (budget.maxTime.IsJust()) {
+    dispatcher.set_max_time(budget.maxTime.UnsafeFromJust());
+  }
+}
+
+NAN_METHOD(EventLoopHelpers::SetFastCallbacks) {
+  CONVERT_ARGS_OR_THROW_AND_RETURN(enabled, bool)
+  EventDispatcher::Current().set_fast_callbacks(enabled);
+}
+
+void EventLoopHelpers::Init(v8::Handle<v8::Object> exports) {
+  Nan::SetMethod(exports, "getEventLoopBudget", GetEventLoopBudget);
+  Nan::SetMethod(exports, "getEventLoopMetrics", GetEventLoopMetrics);
+  Nan::SetMethod(exports, "getFastCallbacks", GetFastCallbacks);
+  Nan::SetMethod(exports, "setEventLoopBudget", SetEventLoopBudget);
+  Nan::SetMethod(exports, "setFastCallbacks", SetFastCallbacks);
+}
+
+}  // namespace node_webrtc
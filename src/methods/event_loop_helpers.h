@@ -0,0 +1,27 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <nan.h>
+#include <v8.h>
+
+namespace node_webrtc {
+
+class EventLoopHelpers {
+ public:
+  static void Init(v8::Handle<v8::Object> exports);
+
+ private:
+  static NAN_METHOD(GetEventLoopBudget);
+  static NAN_METHOD(GetEventLoopMetrics);
+  static NAN_METHOD(GetFastCallbacks);
+  static NAN_METHOD(SetEventLoopBudget);
+  static NAN_METHOD(SetFastCallbacks);
+};
+
+}  // namespace node_webrtc
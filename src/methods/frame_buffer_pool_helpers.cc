@@ -0,0 +1,27 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/methods/frame_buffer_pool_helpers.h"
+
+#include "src/webrtc/frame_buffer_pool.h"
+
+namespace node_webrtc {
+
+NAN_METHOD(FrameBufferPoolHelpers::GetFrameBufferPoolMetrics) {
+  auto& pool = FrameBufferPool::Default();
+  auto result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(pool.hits())));
+  Nan::Set(result, Nan::New("misses").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(pool.misses())));
+  Nan::Set(result, Nan::New("pooledBytes").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(pool.pooled_bytes())));
+  info.GetReturnValue().Set(result);
+}
+
+void FrameBufferPoolHelpers::Init(v8::Handle<v8::Object> exports) {
+  Nan::SetMethod(exports, "getFrameBufferPoolMetrics", GetFrameBufferPoolMetrics);
+}
+
+}  // namespace node_webrtc
@@ -9,6 +9,8 @@
 
 #include <node_version.h>
 
+#include "src/node/event_dispatcher.h"
+
 using node_webrtc::AsyncObjectWrap;
 
 AsyncObjectWrap::AsyncObjectWrap(const char* name)  // NOLINT
@@ -43,6 +45,10 @@ void AsyncObjectWrap::Wrap(v8::Local<v8::Object> object) {
 }
 
 void AsyncObjectWrap::MakeCallback(const char* name, const int argc, v8::Local<v8::Value>* argv) {
+  if (EventDispatcher::Current().is_in_callback_scope()) {
+    MakeFastCallback(name, argc, argv);
+    return;
+  }
   uv_mutex_lock(&_async_resource_lock);
   if (_async_resource) {
     _async_resource->runInAsyncScope(ToObject(), name, argc, argv);
@@ -50,6 +56,31 @@ void AsyncObjectWrap::MakeCallback(const char* name, const int argc, v8::Local<v
   uv_mutex_unlock(&_async_resource_lock);
 }
 
+void AsyncObjectWrap::MakeFastCallback(const char* name, const int argc, v8::Local<v8::Value>* argv) {
+  // The AsyncResource is only ever destroyed on this thread, so there is
+  // no need to take the lock just to check it.
+  if (!_async_resource) {
+    return;
+  }
+  Nan::HandleScope scope;
+  auto object = handle();
+  auto context = object->CreationContext();
+  if (context.IsEmpty()) {
+    return;
+  }
+  v8::Context::Scope context_scope(context);
+  auto maybeCallback = Nan::Get(object, Nan::New(name).ToLocalChecked());
+  v8::Local<v8::Value> callback;
+  if (!maybeCallback.ToLocal(&callback) || !callback->IsFunction()) {
+    return;
+  }
+  // Report exceptions as uncaught, just like node::MakeCallback, without
+  // abandoning the rest of the wakeup.
+  v8::TryCatch tryCatch(v8::Isolate::GetCurrent());
+  tryCatch.SetVerbose(true);
+  Nan::Call(callback.As<v8::Function>(), object, argc, argv);
+}
+
 void AsyncObjectWrap::DestroyAsyncResource() {
   Nan::HandleScope scope;
   uv_mutex_lock(&_async_resource_lock);
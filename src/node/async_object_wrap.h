@@ -66,7 +66,8 @@ class AsyncObjectWrap: private Nan::ObjectWrap {
 
  protected:
   /**
-   * Make a callback.
+   * Make a callback. If the EventDispatcher is running with fast callbacks, this
+   * calls the function directly, skipping the AsyncResource.
    * @param name the name of the callback
    * @param argc the number of arguments
    * @param argv the arguments
@@ -78,6 +79,15 @@ class AsyncObjectWrap: private Nan::ObjectWrap {
   uv_mutex_t _async_resource_lock;
   std::atomic_int _reference_count = {0};
 
+  /**
+   * Make a callback without entering the AsyncResource's scope. This is only
+   * safe inside a node::CallbackScope.
+   * @param name the name of the callback
+   * @param argc the number of arguments
+   * @param argv the arguments
+   */
+  void MakeFastCallback(const char* name, int argc, v8::Local<v8::Value>* argv);
+
   /**
    * Destroy the AsyncResource.
    */
@@ -25,21 +25,48 @@ class AsyncObjectWrapWithLoop
   , private PromiseFulfillingEventLoop<T> {
  public:
   /**
-   * Construct an AsyncObjectWrapWithLoop. The name you provide is the name of the AsyncResource, and the target you
-   * provide is the Event target.
+   * Construct an AsyncObjectWrapWithLoop. The name you provide is the name of the AsyncResource (and the name under
+   * which EventLoopMetrics are collected), and the target you provide is the Event target.
    * @param name the name of the AsyncResource
    * @param target the Event target
+   * @param overflow_policy the OverflowPolicy to apply once over the high-water mark
    */
-  AsyncObjectWrapWithLoop(const char* name, T& target): AsyncObjectWrap(name), PromiseFulfillingEventLoop<T>(target) {}
+  AsyncObjectWrapWithLoop(const char* name, T& target, OverflowPolicy overflow_policy = OverflowPolicy::kDropNewest)
+    : AsyncObjectWrap(name), PromiseFulfillingEventLoop<T>(name, target, overflow_policy) {}
 
   ~AsyncObjectWrapWithLoop() override = default;
 
   /**
    * Dispatch an event to the AsyncObjectWrapWithLoop.
    * @param event the event to dispatch
+   * @param priority the EventPriority of the event
    */
-  void Dispatch(std::unique_ptr<Event<T>> event) {
-    PromiseFulfillingEventLoop<T>::Dispatch(std::move(event));
+  void Dispatch(std::unique_ptr<Event<T>> event, EventPriority priority = EventPriority::kControl) {
+    PromiseFulfillingEventLoop<T>::Dispatch(std::move(event), priority);
+  }
+
+  /**
+   * Get the maximum number of kBulk Events to queue (zero means "unlimited").
+   * @return the high-water mark
+   */
+  uint32_t high_water_mark() const {
+    return PromiseFulfillingEventLoop<T>::high_water_mark();
+  }
+
+  /**
+   * Set the maximum number of kBulk Events to queue.
+   * @param high_water_mark the high-water mark, or zero
+   */
+  void set_high_water_mark(uint32_t high_water_mark) {
+    PromiseFulfillingEventLoop<T>::set_high_water_mark(high_water_mark);
+  }
+
+  /**
+   * Get the number of kBulk Events dropped due to the high-water mark.
+   * @return the number of Events dropped
+   */
+  uint64_t dropped() const {
+    return PromiseFulfillingEventLoop<T>::dropped();
   }
 
   /**
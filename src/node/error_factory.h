@@ -42,7 +42,7 @@ class ErrorFactory {
   static v8::Local<v8::Value> CreateSyntaxError(std::string message);
 
  private:
-  static Nan::Persistent<v8::Function> DOMException;
+  static thread_local Nan::Persistent<v8::Function> DOMException;
 
   static const char* DOMExceptionNameToString(DOMExceptionName name);
 
@@ -0,0 +1,139 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/node/event_dispatcher.h"
+
+#include <thread>
+
+#include <node.h>
+#include <node_version.h>
+
+namespace node_webrtc {
+
+constexpr uint32_t Schedulable::kRetired;
+constexpr uint32_t EventDispatcher::kClosing;
+
+static thread_local EventDispatcher* current = nullptr;
+
+EventDispatcher& EventDispatcher::Current() {
+  if (!current) {
+#if NODE_MAJOR_VERSION >= 10
+    auto isolate = v8::Isolate::GetCurrent();
+    current = new EventDispatcher(node::GetCurrentEventLoop(isolate));
+    node::AddEnvironmentCleanupHook(isolate, [](void* dispatcher) {
+      static_cast<EventDispatcher*>(dispatcher)->Close();
+    }, current);
+#else
+    current = new EventDispatcher(uv_default_loop());
+#endif
+  }
+  return *current;
+}
+
+EventDispatcher::EventDispatcher(uv_loop_t* loop) {
+  uv_async_init(loop, &_async, [](auto handle) {
+    auto self = static_cast<EventDispatcher*>(handle->data);
+    self->Run();
+  });
+  _async.data = this;
+  uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+}
+
+void EventDispatcher::Close() {
+  // Refuse new wakeups, then wait for any uv_async_send already in progress on
+  // another thread before closing the uv_async_t underneath it.
+  _wake_state.fetch_or(kClosing);
+  while (_wake_state.load() != kClosing) {
+    std::this_thread::yield();
+  }
+  uv_close(reinterpret_cast<uv_handle_t*>(&_async), nullptr);
+}
+
+void EventDispatcher::Wake() {
+  if (_wake_state.fetch_add(1) & kClosing) {
+    _wake_state.fetch_sub(1);
+    return;
+  }
+  uv_async_send(&_async);
+  _wake_state.fetch_sub(1);
+}
+
+void EventDispatcher::AddRef() {
+  if (_reference_count++ == 0) {
+    uv_ref(reinterpret_cast<uv_handle_t*>(&_async));
+  }
+}
+
+void EventDispatcher::RemoveRef() {
+  if (--_reference_count == 0) {
+    uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+  }
+}
+
+void EventDispatcher::Run() {
+#if NODE_MAJOR_VERSION >= 10
+  if (_fast_callbacks) {
+    Nan::HandleScope scope;
+    if (_resource.IsEmpty()) {
+      _resource.Reset(Nan::New<v8::Object>());
+    }
+    // Closing the CallbackScope drains the nextTick queue and runs microtasks,
+    // so no separate microtask checkpoint is needed.
+    node::CallbackScope callback_scope(v8::Isolate::GetCurrent(), Nan::New(_resource), {0, 0});
+    _in_callback_scope = true;
+    RunReady();
+    _in_callback_scope = false;
+    _microtask_checkpoint_requested = false;
+  } else {
+    RunReady();
+  }
+#else
+  RunReady();
+#endif
+  if (_microtask_checkpoint_requested) {
+    _microtask_checkpoint_requested = false;
+    Nan::HandleScope scope;
+    v8::Isolate::GetCurrent()->RunMicrotasks();
+  }
+  if (IsReady()) {
+    Wake();
+  }
+}
+
+void EventDispatcher::RunReady() {
+  DispatchBudget budget(_max_events, _max_time);
+  while (true) {
+    auto lane = _ready[static_cast<size_t>(EventPriority::kControl)].Pop();
+    if (!lane) {
+      if (budget.IsExhausted()) {
+        break;
+      }
+      lane = _ready[static_cast<size_t>(EventPriority::kBulk)].Pop();
+      if (!lane) {
+        break;
+      }
+    }
+    // Clear the bit before running, so that events enqueued while the lane
+    // runs schedule it again.
+    lane->owner->_state.fetch_and(~Schedulable::BitOf(lane->priority));
+    // Each run gets its own HandleScope, so that handles created while
+    // draining one Schedulable are released before the next one runs.
+    Nan::HandleScope scope;
+    lane->owner->Run(lane->priority, budget);
+  }
+}
+
+bool EventDispatcher::IsReady() const {
+  for (auto& ready : _ready) {
+    if (!ready.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace node_webrtc
@@ -0,0 +1,288 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <nan.h>
+#include <uv.h>
+#include <v8.h>
+
+#include "src/utilities/mpsc_queue.h"
+#include "events.h"
+
+namespace node_webrtc {
+
+class EventDispatcher;
+
+/**
+ * A DispatchBudget bounds the work an EventDispatcher does per wakeup, both in
+ * events and in time. A limit of zero means "unlimited".
+ */
+class DispatchBudget {
+ public:
+  /**
+   * Start a DispatchBudget now.
+   * @param max_events the maximum number of events to dispatch, or zero
+   * @param max_time the maximum time to spend dispatching, in microseconds, or zero
+   */
+  DispatchBudget(uint32_t max_events, uint32_t max_time)
+    : _max_events(max_events)
+    , _deadline(max_time ? uv_hrtime() + static_cast<uint64_t>(max_time) * 1000 : 0) {}
+
+  /**
+   * Record that an event was dispatched.
+   */
+  void Consume() {
+    _events++;
+  }
+
+  /**
+   * Check whether the DispatchBudget has run out.
+   * @return true if no more events should be dispatched
+   */
+  bool IsExhausted() const {
+    return (_max_events && _events >= _max_events) || (_deadline && uv_hrtime() >= _deadline);
+  }
+
+ private:
+  const uint32_t _max_events;
+  const uint64_t _deadline;
+  uint32_t _events = 0;
+};
+
+/**
+ * A Schedulable has work that an EventDispatcher should run on the thread of
+ * its uv_loop_t. A Schedulable has one lane per EventPriority, and each lane is
+ * on the EventDispatcher's ready lists at most once, no matter how many times
+ * it is scheduled before it runs.
+ */
+class Schedulable {
+  friend class EventDispatcher;
+
+ public:
+  Schedulable() {
+    for (size_t i = 0; i < kNumberOfEventPriorities; i++) {
+      _lanes[i].owner = this;
+      _lanes[i].priority = static_cast<EventPriority>(i);
+    }
+  }
+
+  Schedulable(Schedulable const&) = delete;
+
+  Schedulable& operator=(Schedulable const&) = delete;
+
+  virtual ~Schedulable() = default;
+
+ protected:
+  /**
+   * Run pending work for a lane. The kControl lane should run only kControl
+   * work, and it should run all of it, regardless of the DispatchBudget. The
+   * kBulk lane should run work of any priority, highest first, until there is
+   * none left or the DispatchBudget runs out, in which case it should schedule
+   * itself again. This method is invoked by the EventDispatcher.
+   * @param priority the lane to run
+   * @param budget the DispatchBudget for this wakeup
+   */
+  virtual void Run(EventPriority priority, DispatchBudget& budget) = 0;
+
+ private:
+  struct Lane: public MpscNode<Lane> {
+    Schedulable* owner = nullptr;
+    EventPriority priority = EventPriority::kControl;
+  };
+
+  static constexpr uint32_t kRetired = 1u << kNumberOfEventPriorities;
+
+  static uint32_t BitOf(EventPriority priority) {
+    return 1u << static_cast<uint32_t>(priority);
+  }
+
+  Lane _lanes[kNumberOfEventPriorities];
+
+  // One bit per scheduled lane, plus kRetired.
+  std::atomic<uint32_t> _state = {0};
+};
+
+/**
+ * EventDispatcher shares a single uv_async_t between every Schedulable on a
+ * uv_loop_t. Each JavaScript thread (the main thread and every worker) has its
+ * own EventDispatcher, for its own uv_loop_t. Scheduling pushes onto a lock-free ready list and wakes the loop;
+ * the loop then runs each ready Schedulable in turn. If the DispatchBudget for
+ * a wakeup runs out, the EventDispatcher wakes the loop again and yields, so
+ * that timers and I/O get a chance to run in between.
+ *
+ * Each Schedulable runs under its own HandleScope, and each wakeup ends with at
+ * most one microtask checkpoint, no matter how many Schedulables ran.
+ *
+ * With fast callbacks enabled, each wakeup instead runs inside a single
+ * node::CallbackScope, and AsyncObjectWraps call into JavaScript directly rather
+ * than through their AsyncResources. Closing the CallbackScope drains the
+ * nextTick queue and runs microtasks. The price is that async_hooks (and
+ * anything built on them, like AsyncLocalStorage) cannot attribute these
+ * callbacks to the objects that made them.
+ */
+class EventDispatcher {
+ public:
+  EventDispatcher(EventDispatcher const&) = delete;
+
+  EventDispatcher& operator=(EventDispatcher const&) = delete;
+
+  /**
+   * Get the EventDispatcher for the current JavaScript thread, creating it if
+   * necessary. This method must be called from a JavaScript thread.
+   * @return the current EventDispatcher
+   */
+  static EventDispatcher& Current();
+
+  /**
+   * Schedule a lane of a Schedulable to run. This method may be called from
+   * any thread. Once the EventDispatcher is closed, this method does nothing.
+   * @param schedulable the Schedulable to schedule
+   * @param priority the lane to schedule
+   */
+  void Schedule(Schedulable* schedulable, EventPriority priority) {
+    auto bit = Schedulable::BitOf(priority);
+    auto state = schedulable->_state.fetch_or(bit);
+    if (!(state & (bit | Schedulable::kRetired))) {
+      _ready[static_cast<size_t>(priority)].Push(&schedulable->_lanes[static_cast<size_t>(priority)]);
+      Wake();
+    }
+  }
+
+  /**
+   * Attempt to retire a Schedulable so that it can never be scheduled again.
+   * This fails if any of the Schedulable's lanes are already on a ready list,
+   * in which case it will run again and may retry. This method must be called
+   * from the thread of the uv_loop_t.
+   * @param schedulable the Schedulable to retire
+   * @return true if the Schedulable was retired
+   */
+  bool Retire(Schedulable* schedulable) {
+    uint32_t expected = 0;
+    return schedulable->_state.compare_exchange_strong(expected, Schedulable::kRetired);
+  }
+
+  /**
+   * Request a microtask checkpoint once every ready Schedulable has run. This
+   * method must be called from the thread of the uv_loop_t.
+   */
+  void RequestMicrotaskCheckpoint() {
+    _microtask_checkpoint_requested = true;
+  }
+
+  /**
+   * Keep the uv_loop_t alive. This method must be called from the thread of
+   * the uv_loop_t.
+   */
+  void AddRef();
+
+  /**
+   * Stop keeping the uv_loop_t alive once every AddRef has been matched. This
+   * method must be called from the thread of the uv_loop_t.
+   */
+  void RemoveRef();
+
+  /**
+   * Get the maximum number of events to dispatch per wakeup (zero means
+   * "unlimited").
+   * @return the maximum number of events
+   */
+  uint32_t max_events() const {
+    return _max_events;
+  }
+
+  /**
+   * Get the maximum time to spend dispatching per wakeup, in microseconds (zero
+   * means "unlimited").
+   * @return the maximum time
+   */
+  uint32_t max_time() const {
+    return _max_time;
+  }
+
+  /**
+   * Set the maximum number of events to dispatch per wakeup.
+   * @param max_events the maximum number of events, or zero
+   */
+  void set_max_events(uint32_t max_events) {
+    _max_events = max_events;
+  }
+
+  /**
+   * Set the maximum time to spend dispatching per wakeup.
+   * @param max_time the maximum time, in microseconds, or zero
+   */
+  void set_max_time(uint32_t max_time) {
+    _max_time = max_time;
+  }
+
+  /**
+   * Check whether fast callbacks are enabled.
+   * @return true if fast callbacks are enabled
+   */
+  bool fast_callbacks() const {
+    return _fast_callbacks;
+  }
+
+  /**
+   * Enable or disable fast callbacks, starting with the next wakeup. Fast
+   * callbacks require Node 10 or newer; on older versions, this has no effect.
+   * @param fast_callbacks true to enable fast callbacks
+   */
+  void set_fast_callbacks(bool fast_callbacks) {
+    _fast_callbacks = fast_callbacks;
+  }
+
+  /**
+   * Check whether the EventDispatcher is running Schedulables inside a
+   * node::CallbackScope, in which case callbacks into JavaScript may skip
+   * their AsyncResources. This method must be called from the thread of the
+   * uv_loop_t.
+   * @return true if inside a node::CallbackScope
+   */
+  bool is_in_callback_scope() const {
+    return _in_callback_scope;
+  }
+
+ private:
+  explicit EventDispatcher(uv_loop_t* loop);
+
+  /**
+   * Close the uv_async_t, so that the uv_loop_t can close. EventDispatchers are
+   * never deleted, since Schedulables on other threads may still refer to them.
+   */
+  void Close();
+
+  void Wake();
+
+  void Run();
+
+  void RunReady();
+
+  bool IsReady() const;
+
+  // Once kClosing is set, Wake does nothing. The other bits count the threads
+  // in the middle of a uv_async_send, which Close waits for.
+  static constexpr uint32_t kClosing = 1u << 31;
+
+  uv_async_t _async{};
+  std::atomic<uint32_t> _wake_state = {0};
+  MpscQueue<Schedulable::Lane> _ready[kNumberOfEventPriorities];
+  size_t _reference_count = 0;
+  uint32_t _max_events = 0;
+  uint32_t _max_time = 0;
+  bool _microtask_checkpoint_requested = false;
+  bool _fast_callbacks = false;
+  bool _in_callback_scope = false;
+  Nan::Persistent<v8::Object> _resource;
+};
+
+}  // namespace node_webrtc
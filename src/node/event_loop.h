@@ -12,48 +12,143 @@
 
 #include <uv.h>
 
+#include "src/utilities/latest_ring.h"
+#include "event_dispatcher.h"
+#include "event_loop_metrics.h"
 #include "event_queue.h"
 #include "events.h"
 
 namespace node_webrtc {
 
+/**
+ * The most kBulk Events an EventLoop holds under OverflowPolicy::kDropOldest
+ * with a high-water mark. Higher high-water marks behave like this one.
+ */
+constexpr size_t kMaxLatestEvents = 64;
+
+/**
+ * OverflowPolicy determines which kBulk Events an EventLoop drops once more
+ * than its high-water mark are queued. kControl Events are never dropped.
+ */
+enum class OverflowPolicy {
+  /**
+   * Evict the oldest queued Events as new ones arrive, so that JavaScript sees
+   * the most recent ones (appropriate for video frames). New Events are never
+   * dropped, and no more than the high-water mark (at most kMaxLatestEvents)
+   * are ever held, even if JavaScript stops dequeueing altogether.
+   */
+  kDropOldest,
+
+  /**
+   * Drop new Events as they are dispatched (appropriate for audio data, where
+   * gaps are less disruptive than skipping ahead).
+   */
+  kDropNewest
+};
+
 /**
  * EventLoop is a thread-safe Event loop. It allows you to dispatch events from
- * one thread and handle them in another (or the same).
+ * one thread and handle them in another (or the same). Every EventLoop shares
+ * the default EventDispatcher, rather than owning a uv_async_t of its own, and
+ * drains only as many events as the EventDispatcher's budget allows. kControl
+ * Events are always dispatched before kBulk Events, even those enqueued
+ * earlier. Under OverflowPolicy::kDropOldest with a high-water mark, kBulk
+ * Events are held in a LatestRing instead, which is lock-free, too.
  * @tparam T the Event target type
  */
 template <typename T>
-class EventLoop: private EventQueue<T> {
+class EventLoop
+  : private EventQueue<T>
+  , private Schedulable {
  public:
   /**
    * Dispatch an event to the EventLoop.
    * @param event the event to dispatch
+   * @param priority the EventPriority of the event
    */
-  void Dispatch(std::unique_ptr<Event<T>> event) {
-    this->Enqueue(std::move(event));
-    uv_mutex_lock(&_lock);
-    if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(&_async))) {
-      uv_async_send(&_async);
+  void Dispatch(std::unique_ptr<Event<T>> event, EventPriority priority = EventPriority::kControl) {
+    if (priority == EventPriority::kBulk && _latest && _high_water_mark) {
+      DispatchLatest(std::move(event));
+      return;
+    }
+    if (priority == EventPriority::kBulk && _overflow_policy == OverflowPolicy::kDropNewest) {
+      auto depth = _bulk_depth.fetch_add(1) + 1;
+      auto limit = static_cast<int64_t>(_high_water_mark.load());
+      if (limit && depth > limit) {
+        _bulk_depth.fetch_sub(1);
+        DidDrop();
+        return;
+      }
     }
-    uv_mutex_unlock(&_lock);
+    _metrics.DidEnqueue();
+    this->Enqueue(std::move(event), priority);
+    _dispatcher.Schedule(this, priority);
   }
 
   ~EventLoop() override {
-    uv_mutex_destroy(&_lock);
+    while (this->Dequeue()) {
+      _metrics.DidDiscard();
+    }
+    if (_latest) {
+      _latest->Clear([this](Event<T>* event) {
+        delete event;
+        _metrics.DidDiscard();
+      });
+    }
   }
 
   bool should_stop() const {
     return _should_stop;
   }
 
+  /**
+   * Get the maximum number of kBulk Events to queue (zero means "unlimited").
+   * @return the high-water mark
+   */
+  uint32_t high_water_mark() const {
+    return _high_water_mark;
+  }
+
+  /**
+   * Set the maximum number of kBulk Events to queue. This method may be called
+   * from any thread.
+   * @param high_water_mark the high-water mark, or zero
+   */
+  void set_high_water_mark(uint32_t high_water_mark) {
+    _high_water_mark = high_water_mark;
+  }
+
+  /**
+   * Get the number of kBulk Events dropped due to the high-water mark.
+   * @return the number of Events dropped
+   */
+  uint64_t dropped() const {
+    return _dropped;
+  }
+
  protected:
-  explicit EventLoop(T& target): EventQueue<T>(), _loop(uv_default_loop()), _target(target) {
-    uv_async_init(_loop, &_async, [](auto handle) {
-      auto self = static_cast<EventLoop<T>*>(handle->data);
-      self->Run();
-    });
-    _async.data = this;
-    uv_mutex_init(&_lock);
+  /**
+   * Construct an EventLoop. EventLoops with the same name share EventLoopMetrics.
+   * @param name the name of the EventLoop
+   * @param target the Event target
+   * @param overflow_policy the OverflowPolicy to apply once over the high-water mark
+   */
+  EventLoop(const char* name, T& target, OverflowPolicy overflow_policy = OverflowPolicy::kDropNewest)
+    : EventQueue<T>()
+    , _dispatcher(EventDispatcher::Current())
+    , _metrics(EventLoopMetrics::For(name))
+    , _overflow_policy(overflow_policy)
+    , _latest(overflow_policy == OverflowPolicy::kDropOldest ? new LatestEvents() : nullptr)
+    , _target(target) {
+    _dispatcher.AddRef();
+  }
+
+  /**
+   * Get the EventDispatcher that runs the EventLoop.
+   * @return the EventDispatcher
+   */
+  EventDispatcher& dispatcher() {
+    return _dispatcher;
   }
 
   /**
@@ -63,22 +158,35 @@ class EventLoop: private EventQueue<T> {
     // Do nothing.
   }
 
-  virtual void Run() {
+  void Run(EventPriority priority, DispatchBudget& budget) override {
+    auto isControl = priority == EventPriority::kControl;
     if (!_should_stop) {
-      while (auto event = this->Dequeue()) {
+      while (isControl || !budget.IsExhausted()) {
+        auto event = isControl ? this->Dequeue(priority) : this->Dequeue();
+        if (!event && !isControl && _latest) {
+          event = std::unique_ptr<Event<T>>(_latest->Pop());
+        }
+        if (!event) {
+          break;
+        }
+        if (event->priority() == EventPriority::kBulk && _overflow_policy == OverflowPolicy::kDropNewest) {
+          _bulk_depth.fetch_sub(1);
+        }
+        _metrics.DidDispatch((uv_hrtime() - event->enqueued_at()) / 1000);
         event->Dispatch(_target);
+        budget.Consume();
         if (_should_stop) {
           break;
         }
       }
+      if (!isControl && !_should_stop && (!this->empty(EventPriority::kBulk)
+          || (_latest && !_latest->empty()))) {
+        _dispatcher.Schedule(this, EventPriority::kBulk);
+      }
     }
-    if (_should_stop) {
-      uv_mutex_lock(&_lock);
-      uv_close(reinterpret_cast<uv_handle_t*>(&_async), [](auto handle) {
-        auto self = static_cast<EventLoop<T>*>(handle->data);
-        self->DidStop();
-      });
-      uv_mutex_unlock(&_lock);
+    if (_should_stop && _dispatcher.Retire(this)) {
+      _dispatcher.RemoveRef();
+      DidStop();
     }
   }
 
@@ -91,9 +199,36 @@ class EventLoop: private EventQueue<T> {
   }
 
  private:
-  uv_async_t _async{};
-  uv_mutex_t _lock{};
-  uv_loop_t* _loop;
+  using LatestEvents = LatestRing<Event<T>, kMaxLatestEvents>;
+
+  void DidDrop() {
+    _dropped++;
+    _metrics.DidDrop();
+  }
+
+  /**
+   * Queue a kBulk Event under OverflowPolicy::kDropOldest, evicting the oldest
+   * queued ones to stay within the high-water mark.
+   * @param event the event to dispatch
+   */
+  void DispatchLatest(std::unique_ptr<Event<T>> event) {
+    this->Stamp(*event, EventPriority::kBulk);
+    _metrics.DidEnqueue();
+    _latest->Push(event.release(), _high_water_mark, [this](Event<T>* evicted) {
+      delete evicted;
+      _metrics.DidDiscard();
+      DidDrop();
+    });
+    _dispatcher.Schedule(this, EventPriority::kBulk);
+  }
+
+  EventDispatcher& _dispatcher;
+  EventLoopMetrics& _metrics;
+  const OverflowPolicy _overflow_policy;
+  std::atomic<uint32_t> _high_water_mark = {0};
+  std::atomic<int64_t> _bulk_depth = {0};
+  const std::unique_ptr<LatestEvents> _latest;
+  std::atomic<uint64_t> _dropped = {0};
   std::atomic<bool> _should_stop = {false};
   T& _target;
 };
@@ -0,0 +1,115 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/node/event_loop_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace node_webrtc {
+
+constexpr size_t LatencyHistogram::kSubBuckets;
+constexpr size_t LatencyHistogram::kMaxMagnitude;
+constexpr size_t LatencyHistogram::kNumberOfBuckets;
+
+static size_t Magnitude(uint64_t value) {
+  size_t magnitude = 0;
+  while (value >>= 1) {
+    magnitude++;
+  }
+  return magnitude;
+}
+
+size_t LatencyHistogram::BucketOf(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  auto magnitude = std::min(Magnitude(value), kMaxMagnitude);
+  if (magnitude == kMaxMagnitude) {
+    return kNumberOfBuckets - 1;
+  }
+  auto subBucket = static_cast<size_t>(value >> (magnitude - 3)) & (kSubBuckets - 1);
+  return (magnitude - 2) * kSubBuckets + subBucket;
+}
+
+uint64_t LatencyHistogram::HighestValueIn(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  auto magnitude = bucket / kSubBuckets + 2;
+  auto subBucket = bucket % kSubBuckets;
+  auto lowest = static_cast<uint64_t>(kSubBuckets + subBucket) << (magnitude - 3);
+  return lowest + (static_cast<uint64_t>(1) << (magnitude - 3)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  _buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+  _count.fetch_add(1, std::memory_order_relaxed);
+  _sum.fetch_add(value, std::memory_order_relaxed);
+  auto min = _min.load(std::memory_order_relaxed);
+  while (value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+    // Do nothing.
+  }
+  auto max = _max.load(std::memory_order_relaxed);
+  while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    // Do nothing.
+  }
+}
+
+uint64_t LatencyHistogram::min() const {
+  return count() ? _min.load(std::memory_order_relaxed) : 0;
+}
+
+double LatencyHistogram::mean() const {
+  auto n = count();
+  return n ? static_cast<double>(_sum.load(std::memory_order_relaxed)) / n : 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  auto n = count();
+  if (!n) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(std::max(0.0, std::min(percentile, 100.0)) / 100 * n));
+  rank = std::max(rank, static_cast<uint64_t>(1));
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kNumberOfBuckets; bucket++) {
+    seen += _buckets[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(HighestValueIn(bucket), max());
+    }
+  }
+  return max();
+}
+
+static std::mutex& registry_lock() {
+  static auto lock = new std::mutex();
+  return *lock;
+}
+
+static std::map<std::string, EventLoopMetrics*>& registry() {
+  static auto registry = new std::map<std::string, EventLoopMetrics*>();
+  return *registry;
+}
+
+EventLoopMetrics& EventLoopMetrics::For(const std::string& name) {
+  std::lock_guard<std::mutex> lock(registry_lock());
+  auto& metrics = registry()[name];
+  if (!metrics) {
+    metrics = new EventLoopMetrics();
+  }
+  return *metrics;
+}
+
+std::vector<std::pair<std::string, EventLoopMetrics*>> EventLoopMetrics::All() {
+  std::lock_guard<std::mutex> lock(registry_lock());
+  return std::vector<std::pair<std::string, EventLoopMetrics*>>(registry().begin(), registry().end());
+}
+
+}  // namespace node_webrtc
@@ -0,0 +1,149 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace node_webrtc {
+
+/**
+ * LatencyHistogram is a lock-free, HDR-style histogram of latencies in
+ * microseconds. Values below 8 are recorded exactly; above that, each power of
+ * two is split into 8 linear buckets, so every value is recorded within 12.5%.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+
+  LatencyHistogram(LatencyHistogram const&) = delete;
+
+  LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+  /**
+   * Record a latency. This method may be called from any thread.
+   * @param value the latency, in microseconds
+   */
+  void Record(uint64_t value);
+
+  uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+  uint64_t min() const;
+
+  uint64_t max() const { return _max.load(std::memory_order_relaxed); }
+
+  double mean() const;
+
+  /**
+   * Get a percentile. The result is the highest value that would be recorded in
+   * the same bucket as the percentile, capped at max().
+   * @param percentile the percentile, between 0 and 100
+   * @return the percentile, in microseconds
+   */
+  uint64_t Percentile(double percentile) const;
+
+  static size_t BucketOf(uint64_t value);
+
+  static uint64_t HighestValueIn(size_t bucket);
+
+ private:
+  static constexpr size_t kSubBuckets = 8;
+  static constexpr size_t kMaxMagnitude = 40;
+  static constexpr size_t kNumberOfBuckets = (kMaxMagnitude - 1) * kSubBuckets;
+
+  std::atomic<uint64_t> _buckets[kNumberOfBuckets] = {};
+  std::atomic<uint64_t> _count = {0};
+  std::atomic<uint64_t> _sum = {0};
+  std::atomic<uint64_t> _min = {UINT64_MAX};
+  std::atomic<uint64_t> _max = {0};
+};
+
+/**
+ * EventLoopMetrics collects queue depth and enqueue-to-dispatch latency for
+ * every EventLoop with the same name (for example, "RTCPeerConnection").
+ */
+class EventLoopMetrics {
+ public:
+  EventLoopMetrics() = default;
+
+  EventLoopMetrics(EventLoopMetrics const&) = delete;
+
+  EventLoopMetrics& operator=(EventLoopMetrics const&) = delete;
+
+  /**
+   * Get the EventLoopMetrics for a name, creating them if necessary.
+   * @param name the name
+   * @return the EventLoopMetrics
+   */
+  static EventLoopMetrics& For(const std::string& name);
+
+  /**
+   * Get every EventLoopMetrics created so far, by name.
+   * @return the EventLoopMetrics
+   */
+  static std::vector<std::pair<std::string, EventLoopMetrics*>> All();
+
+  /**
+   * Record that an event was enqueued. This method may be called from any thread.
+   */
+  void DidEnqueue() {
+    auto depth = _depth.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto peak = _peak_depth.load(std::memory_order_relaxed);
+    while (depth > peak && !_peak_depth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+      // Do nothing.
+    }
+  }
+
+  /**
+   * Record that an event was dispatched.
+   * @param latency the time between enqueueing and dispatching, in microseconds
+   */
+  void DidDispatch(uint64_t latency) {
+    _depth.fetch_sub(1, std::memory_order_relaxed);
+    _dispatched.fetch_add(1, std::memory_order_relaxed);
+    _latency.Record(latency);
+  }
+
+  /**
+   * Record that an event was discarded without being dispatched.
+   */
+  void DidDiscard() {
+    _depth.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Record that an event was dropped because its EventLoop was over its
+   * high-water mark. This method may be called from any thread.
+   */
+  void DidDrop() {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  int64_t depth() const { return _depth.load(std::memory_order_relaxed); }
+
+  int64_t peak_depth() const { return _peak_depth.load(std::memory_order_relaxed); }
+
+  uint64_t dispatched() const { return _dispatched.load(std::memory_order_relaxed); }
+
+  uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+  const LatencyHistogram& latency() const { return _latency; }
+
+ private:
+  std::atomic<int64_t> _depth = {0};
+  std::atomic<int64_t> _peak_depth = {0};
+  std::atomic<uint64_t> _dispatched = {0};
+  std::atomic<uint64_t> _dropped = {0};
+  LatencyHistogram _latency;
+};
+
+}  // namespace node_webrtc
@@ -0,0 +1,188 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/node/event_pool.h"
+
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "src/utilities/mpsc_queue.h"
+
+namespace node_webrtc {
+
+namespace {
+
+class Cache;
+
+constexpr size_t kNumberOfBuckets = 4;
+constexpr size_t kSizeOfSmallestBucket = 64;
+constexpr size_t kMaxFreeBlocksPerBucket = 1024;
+
+/**
+ * Every block starts with a Header recording the Cache it belongs to (or
+ * nullptr, if it was not pooled) and its bucket.
+ */
+struct alignas(std::max_align_t) Header {
+  Cache* owner;
+  size_t bucket;
+};
+
+/**
+ * A FreeBlock occupies the payload of a block while the block is free.
+ */
+struct FreeBlock: public MpscNode<FreeBlock> {
+  FreeBlock* next = nullptr;
+};
+
+static_assert(sizeof(Header) + sizeof(FreeBlock) <= kSizeOfSmallestBucket, "FreeBlock must fit in the smallest bucket");
+
+size_t SizeOfBucket(size_t bucket) {
+  return kSizeOfSmallestBucket << bucket;
+}
+
+Header* HeaderOf(void* payload) {
+  return static_cast<Header*>(payload) - 1;
+}
+
+/**
+ * A Cache holds the free lists of one thread. Other threads return blocks to
+ * it through an MpscQueue, which the owning thread drains when a free list
+ * runs dry.
+ */
+class Cache {
+ public:
+  void* Allocate(size_t bucket) {
+    if (!_free[bucket]) {
+      Reclaim();
+    }
+    auto block = _free[bucket];
+    if (!block) {
+      auto header = static_cast<Header*>(::operator new(SizeOfBucket(bucket)));
+      header->owner = this;
+      header->bucket = bucket;
+      return header + 1;
+    }
+    _free[bucket] = block->next;
+    _count[bucket]--;
+    return block;
+  }
+
+  /**
+   * Release a block allocated by this Cache. Only the owning thread may call this.
+   */
+  void Release(void* payload) {
+    auto header = HeaderOf(payload);
+    auto bucket = header->bucket;
+    if (_count[bucket] >= kMaxFreeBlocksPerBucket) {
+      ::operator delete(header);
+      return;
+    }
+    auto block = new (payload) FreeBlock();
+    block->next = _free[bucket];
+    _free[bucket] = block;
+    _count[bucket]++;
+  }
+
+  /**
+   * Return a block allocated by this Cache. Any thread may call this.
+   */
+  void Return(void* payload) {
+    _returned.Push(new (payload) FreeBlock());
+  }
+
+ private:
+  void Reclaim() {
+    while (auto block = _returned.Pop()) {
+      Release(block);
+    }
+  }
+
+  FreeBlock* _free[kNumberOfBuckets] = {};
+  size_t _count[kNumberOfBuckets] = {};
+  MpscQueue<FreeBlock> _returned;
+};
+
+/**
+ * Caches outlive their threads, since blocks may still be returned to them.
+ * When a thread exits, its Cache is orphaned, and the next new thread adopts it.
+ */
+std::mutex& orphans_lock() {
+  static auto lock = new std::mutex();
+  return *lock;
+}
+
+std::vector<Cache*>& orphans() {
+  static auto orphans = new std::vector<Cache*>();
+  return *orphans;
+}
+
+thread_local Cache* current = nullptr;
+thread_local bool exited = false;
+
+class CacheHolder {
+ public:
+  CacheHolder() {
+    std::lock_guard<std::mutex> lock(orphans_lock());
+    if (orphans().empty()) {
+      current = new Cache();
+    } else {
+      current = orphans().back();
+      orphans().pop_back();
+    }
+  }
+
+  ~CacheHolder() {
+    std::lock_guard<std::mutex> lock(orphans_lock());
+    orphans().push_back(current);
+    current = nullptr;
+    exited = true;
+  }
+};
+
+Cache* GetCurrentCache() {
+  if (!current && !exited) {
+    static thread_local CacheHolder holder;
+  }
+  return current;
+}
+
+}  // namespace
+
+void* EventPool::Allocate(size_t size) {
+  auto total = size + sizeof(Header);
+  for (size_t bucket = 0; bucket < kNumberOfBuckets; bucket++) {
+    if (total <= SizeOfBucket(bucket)) {
+      if (auto cache = GetCurrentCache()) {
+        return cache->Allocate(bucket);
+      }
+      break;
+    }
+  }
+  auto header = static_cast<Header*>(::operator new(total));
+  header->owner = nullptr;
+  header->bucket = kNumberOfBuckets;
+  return header + 1;
+}
+
+void EventPool::Deallocate(void* pointer) {
+  if (!pointer) {
+    return;
+  }
+  auto header = HeaderOf(pointer);
+  auto owner = header->owner;
+  if (!owner) {
+    ::operator delete(header);
+  } else if (owner == current) {
+    owner->Release(pointer);
+  } else {
+    owner->Return(pointer);
+  }
+}
+
+}  // namespace node_webrtc
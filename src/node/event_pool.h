@@ -0,0 +1,43 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace node_webrtc {
+
+/**
+ * EventPool recycles the memory of Events, so that dispatching an Event does
+ * not cost a malloc/free pair.
+ *
+ * Each thread allocates from its own size-bucketed free lists. Events are
+ * usually allocated on a WebRTC thread and freed on the main thread; in that
+ * case, the memory is handed back to the allocating thread through a lock-free
+ * queue, and that thread reuses it the next time its free list runs dry.
+ * Allocations too large for any bucket fall back to the global allocator.
+ */
+class EventPool {
+ public:
+  EventPool() = delete;
+
+  /**
+   * Allocate memory. This method may be called from any thread.
+   * @param size the number of bytes to allocate
+   * @return the allocated memory
+   */
+  static void* Allocate(size_t size);
+
+  /**
+   * Deallocate memory returned by Allocate. This method may be called from any
+   * thread.
+   * @param pointer the memory to deallocate
+   */
+  static void Deallocate(void* pointer);
+};
+
+}  // namespace node_webrtc
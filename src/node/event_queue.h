@@ -8,61 +8,109 @@
 #pragma once
 
 #include <memory>
-#include <queue>
 
 #include <uv.h>
 
+#include "src/utilities/mpsc_queue.h"
 #include "events.h"
 
 namespace node_webrtc {
 
 /**
  * EventQueue is a thread-safe Event queue. It allows you to enqueue events
- * from one thread and dequeue them from another (or the same).
+ * from any number of threads and dequeue them from one other (or the same).
+ * Enqueueing and dequeueing are lock-free. Each EventPriority has its own FIFO;
+ * higher priority Events are dequeued first.
  * @tparam T the Event target type
  */
 template <typename T>
 class EventQueue {
  public:
   /**
-   * Enqueue an Event.
+   * Enqueue an Event. This method may be called from any thread. The first
+   * time an Event is enqueued, it is stamped with the current time.
    * @param event the event to enqueue
+   * @param priority the EventPriority of the event
    */
-  void Enqueue(std::unique_ptr<Event<T>> event) {
-    uv_mutex_lock(&_lock);
-    _events.push(std::move(event));
-    uv_mutex_unlock(&_lock);
+  void Enqueue(std::unique_ptr<Event<T>> event, EventPriority priority = EventPriority::kControl) {
+    Stamp(*event, priority);
+    _events[static_cast<size_t>(priority)].Push(event.release());
   }
 
   /**
-   * Attempt to dequeue an Event. If the EventQueue is empty, this method
-   * returns nullptr.
+   * Attempt to dequeue an Event, highest EventPriority first. If the
+   * EventQueue is empty, this method returns nullptr. This method must only be
+   * called from one thread.
    * @return the dequeued Event or nullptr
    */
   std::unique_ptr<Event<T>> Dequeue() {
-    uv_mutex_lock(&_lock);
-    if (_events.empty()) {
-      uv_mutex_unlock(&_lock);
-      return nullptr;
+    for (auto& events : _events) {
+      if (auto event = events.Pop()) {
+        return std::unique_ptr<Event<T>>(event);
+      }
     }
-    auto event = std::move(_events.front());
-    _events.pop();
-    uv_mutex_unlock(&_lock);
-    return event;
+    return nullptr;
+  }
+
+  /**
+   * Attempt to dequeue an Event with a particular EventPriority. This method
+   * must only be called from the thread that dequeues.
+   * @param priority the EventPriority
+   * @return the dequeued Event or nullptr
+   */
+  std::unique_ptr<Event<T>> Dequeue(EventPriority priority) {
+    return std::unique_ptr<Event<T>>(_events[static_cast<size_t>(priority)].Pop());
+  }
+
+  /**
+   * Check whether the EventQueue is empty. This method must only be called
+   * from the thread that dequeues.
+   * @return true if the EventQueue is empty
+   */
+  bool empty() const {
+    for (auto& events : _events) {
+      if (!events.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Check whether the EventQueue has no Events with a particular
+   * EventPriority. This method must only be called from the thread that
+   * dequeues.
+   * @param priority the EventPriority
+   * @return true if there are no such Events
+   */
+  bool empty(EventPriority priority) const {
+    return _events[static_cast<size_t>(priority)].empty();
   }
 
   virtual ~EventQueue() {
-    uv_mutex_destroy(&_lock);
+    while (Dequeue()) {
+      // Do nothing.
+    }
   }
 
  protected:
-  EventQueue() {
-    uv_mutex_init(&_lock);
+  EventQueue() = default;
+
+  /**
+   * Stamp an Event as if it were being enqueued, for subclasses that hold some
+   * Events outside of the EventQueue.
+   * @param event the event
+   * @param priority the EventPriority of the event
+   */
+  static void Stamp(Event<T>& event, EventPriority priority) {
+    if (!event._enqueued_at) {
+      event._enqueued_at = uv_hrtime();
+    }
+    event._priority = priority;
   }
 
  private:
-  std::queue<std::unique_ptr<Event<T>>> _events;
-  uv_mutex_t _lock{};
+  MpscQueue<Event<T>> _events[kNumberOfEventPriorities];
 };
 
 }  // namespace node_webrtc
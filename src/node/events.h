@@ -7,17 +7,39 @@
  */
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
+#include "src/utilities/mpsc_queue.h"
+#include "event_pool.h"
+
 namespace node_webrtc {
 
+template <typename T> class EventQueue;
+
+/**
+ * EventPriority determines the order in which Events are dispatched. Control
+ * Events (state changes, ICE candidates, promise resolutions, etc.) are always
+ * dispatched before Bulk Events (video frames, audio data and messages).
+ */
+enum class EventPriority {
+  kControl = 0,
+  kBulk = 1
+};
+
+constexpr size_t kNumberOfEventPriorities = 2;
+
 /**
- * Event represents an event that can be dispatched to a target.
+ * Event represents an event that can be dispatched to a target. Events, along
+ * with anything their subclasses store inline, are allocated from the
+ * EventPool.
  * @tparam T the target type
  */
 template<typename T>
-class Event {
+class Event: public MpscNode<Event<T>> {
+  friend class EventQueue<T>;
+
  public:
   /**
    * Dispatch the Event to the target.
@@ -29,9 +51,37 @@ class Event {
 
   virtual ~Event() = default;
 
+  static void* operator new(size_t size) {
+    return EventPool::Allocate(size);
+  }
+
+  static void operator delete(void* pointer) {
+    EventPool::Deallocate(pointer);
+  }
+
   static std::unique_ptr<Event<T>> Create() {
     return std::unique_ptr<Event<T>>(new Event<T>());
   }
+
+  /**
+   * Get the time the Event was first enqueued.
+   * @return the time, in nanoseconds (see uv_hrtime), or zero
+   */
+  uint64_t enqueued_at() const {
+    return _enqueued_at;
+  }
+
+  /**
+   * Get the EventPriority the Event was last enqueued with.
+   * @return the EventPriority
+   */
+  EventPriority priority() const {
+    return _priority;
+  }
+
+ private:
+  uint64_t _enqueued_at = 0;
+  EventPriority _priority = EventPriority::kControl;
 };
 
 template <typename F, typename T>
@@ -55,20 +105,25 @@ static std::unique_ptr<Callback<F, T>> CreateCallback(F callback) {
   return Callback<F, T>::Create(std::move(callback));
 }
 
-template <typename T>
+template <typename F, typename T>
 class Callback1: public Event<T> {
  public:
   void Dispatch(T& target) override {
     _callback(target);
   }
 
-  static std::unique_ptr<Callback1<T>> Create(std::function<void(T&)> callback) {
-    return std::unique_ptr<Callback1<T>>(new Callback1(std::move(callback)));
+  static std::unique_ptr<Callback1<F, T>> Create(F callback) {
+    return std::unique_ptr<Callback1<F, T>>(new Callback1(std::move(callback)));
   }
 
  private:
-  explicit Callback1(const std::function<void(T&)>& callback): _callback(callback) {}
-  const std::function<void(T&)> _callback;
+  explicit Callback1(F callback): _callback(std::move(callback)) {}
+  F _callback;
 };
 
+template <typename T, typename F>
+static std::unique_ptr<Callback1<F, T>> CreateCallback1(F callback) {
+  return Callback1<F, T>::Create(std::move(callback));
+}
+
 }  // namespace node_webrtc
@@ -0,0 +1,146 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#include <nan.h>
+#include <v8.h>
+
+namespace node_webrtc {
+
+/**
+ * ExternalArrayBuffer creates ArrayBuffers over memory owned by some other
+ * object (for example, an rtc::CopyOnWriteBuffer), without copying. The owner
+ * is kept alive until the ArrayBuffer is garbage collected, or, for
+ * ArrayBuffers created with NewReleasable, until it is released.
+ */
+class ExternalArrayBuffer {
+ public:
+  ExternalArrayBuffer() = delete;
+
+  /**
+   * Create an ArrayBuffer over memory kept alive by an owner.
+   * @tparam T the owner type
+   * @param data the memory
+   * @param size the size of the memory, in bytes
+   * @param owner the owner of the memory
+   * @return the ArrayBuffer
+   */
+  template <typename T>
+  static v8::Local<v8::ArrayBuffer> New(void* data, size_t size, T owner) {
+    return Create(data, size, std::move(owner), false);
+  }
+
+  /**
+   * Like New, but the ArrayBuffer can also be released (see Release) before it
+   * is garbage collected.
+   * @tparam T the owner type
+   * @param data the memory
+   * @param size the size of the memory, in bytes
+   * @param owner the owner of the memory
+   * @return the ArrayBuffer
+   */
+  template <typename T>
+  static v8::Local<v8::ArrayBuffer> NewReleasable(void* data, size_t size, T owner) {
+    return Create(data, size, std::move(owner), true);
+  }
+
+  /**
+   * Release an ArrayBuffer created with NewReleasable on this thread: detach it,
+   * so that JavaScript can no longer reach its memory, and drop its owner now,
+   * rather than whenever the ArrayBuffer is garbage collected.
+   * @param arrayBuffer the ArrayBuffer
+   * @return false if the ArrayBuffer was not releasable, or already released
+   */
+  static bool Release(v8::Local<v8::ArrayBuffer> arrayBuffer) {
+    auto range = releasable().equal_range(arrayBuffer->GetContents().Data());
+    for (auto it = range.first; it != range.second; it++) {
+      auto holder = it->second;
+      if (holder->handle == arrayBuffer) {
+        releasable().erase(it);
+#if V8_MAJOR_VERSION > 7 || (V8_MAJOR_VERSION == 7 && V8_MINOR_VERSION >= 3)
+        arrayBuffer->Detach();
+#else
+        arrayBuffer->Neuter();
+#endif
+        holder->handle.Reset();
+        Nan::AdjustExternalMemory(-static_cast<int>(holder->size));
+        delete holder;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  struct HolderBase {
+    HolderBase(void* data, size_t size, bool releasable): data(data), size(size), releasable(releasable) {}
+
+    virtual ~HolderBase() = default;
+
+    Nan::Persistent<v8::ArrayBuffer> handle;
+    void* data;
+    size_t size;
+    bool releasable;
+  };
+
+  template <typename T>
+  struct Holder: public HolderBase {
+    Holder(T owner, void* data, size_t size, bool releasable): HolderBase(data, size, releasable), owner(std::move(owner)) {}
+
+    static void Release(const Nan::WeakCallbackInfo<Holder<T>>& info) {
+      auto holder = info.GetParameter();
+      if (holder->releasable) {
+        auto range = releasable().equal_range(holder->data);
+        for (auto it = range.first; it != range.second; it++) {
+          if (it->second == holder) {
+            releasable().erase(it);
+            break;
+          }
+        }
+      }
+      Nan::AdjustExternalMemory(-static_cast<int>(holder->size));
+      delete holder;
+    }
+
+    T owner;
+  };
+
+  template <typename T>
+  static v8::Local<v8::ArrayBuffer> Create(void* data, size_t size, T owner, bool isReleasable) {
+    Nan::EscapableHandleScope scope;
+    auto isolate = v8::Isolate::GetCurrent();
+    if (!data || !size) {
+      return scope.Escape(v8::ArrayBuffer::New(isolate, 0));
+    }
+    auto arrayBuffer = v8::ArrayBuffer::New(isolate, data, size, v8::ArrayBufferCreationMode::kExternalized);
+    auto holder = new Holder<T>(std::move(owner), data, size, isReleasable);
+    holder->handle.Reset(arrayBuffer);
+    holder->handle.SetWeak(holder, &Holder<T>::Release, Nan::WeakCallbackType::kParameter);
+    if (isReleasable) {
+      releasable().emplace(data, holder);
+    }
+    Nan::AdjustExternalMemory(static_cast<int>(size));
+    return scope.Escape(arrayBuffer);
+  }
+
+  /**
+   * The releasable ArrayBuffers on this thread, by address. More than one
+   * ArrayBuffer may share the same memory (for example, when two RTCVideoSinks
+   * receive the same frame).
+   */
+  static std::unordered_multimap<void*, HolderBase*>& releasable() {
+    static thread_local std::unordered_multimap<void*, HolderBase*> releasable;
+    return releasable;
+  }
+};
+
+}  // namespace node_webrtc
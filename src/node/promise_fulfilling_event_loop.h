@@ -7,29 +7,30 @@
  */
 #pragma once
 
-#include <nan.h>
-#include <uv.h>
-
+#include "event_dispatcher.h"
 #include "event_loop.h"
 
 namespace node_webrtc {
 
 /**
  * A PromiseFulfillingEventLoop is an EventLoop that can also fulfill Promises.
+ * Rather than run a microtask checkpoint after every drain, it asks the
+ * EventDispatcher for a single checkpoint once every ready EventLoop has run.
+ * Promises are still resolved in the order their Events were dispatched.
  * @tparam T the Event target type
  */
 template <typename T>
 class PromiseFulfillingEventLoop: public EventLoop<T> {
  protected:
-  explicit PromiseFulfillingEventLoop(T& target): EventLoop<T>(target) {}
+  PromiseFulfillingEventLoop(const char* name, T& target, OverflowPolicy overflow_policy = OverflowPolicy::kDropNewest)
+    : EventLoop<T>(name, target, overflow_policy) {}
 
   ~PromiseFulfillingEventLoop() override = default;
 
-  void Run() override {
-    Nan::HandleScope scope;
-    EventLoop<T>::Run();
+  void Run(EventPriority priority, DispatchBudget& budget) override {
+    EventLoop<T>::Run(priority, budget);
     if (!this->should_stop()) {
-      Nan::GetCurrentContext()->GetIsolate()->RunMicrotasks();
+      this->dispatcher().RequestMicrotaskCheckpoint();
     }
   }
 };
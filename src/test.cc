@@ -12,8 +12,21 @@
 #define CATCH_CONFIG_RUNNER
 #include <catch2/catch.hpp>
 
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "src/converters.h"
 #include "src/converters/v8.h"
+#include "src/node/event_pool.h"
+#include "src/utilities/latest_ring.h"
+#include "src/utilities/mpsc_queue.h"
+#include "src/utilities/shared_ring.h"
+#include "src/webrtc/data_channel_compression.h"
+#include "src/webrtc/data_channel_framing.h"
+#include "src/webrtc/frame_buffer_pool.h"
 
 TEST_CASE("converting booleans", "[converting-booleans]") {
   SECTION("from JavaScript") {  // NOLINT
@@ -102,6 +115,389 @@ TEST_CASE("converting arrays", "[converting-arrays]") {
   }
 }
 
+namespace {
+
+struct TestNode: public node_webrtc::MpscNode<TestNode> {
+  TestNode(int producer, int sequence): producer(producer), sequence(sequence) {}
+  int producer;
+  int sequence;
+};
+
+}  // namespace
+
+TEST_CASE("MpscQueue", "[mpsc-queue]") {
+  SECTION("pops nullptr when empty") {
+    node_webrtc::MpscQueue<TestNode> queue;
+    REQUIRE(queue.empty());
+    REQUIRE(queue.Pop() == nullptr);
+  }
+
+  SECTION("pops in FIFO order") {
+    node_webrtc::MpscQueue<TestNode> queue;
+    TestNode a(0, 0), b(0, 1), c(0, 2);
+    queue.Push(&a);
+    queue.Push(&b);
+    REQUIRE(queue.Pop() == &a);
+    queue.Push(&c);
+    REQUIRE(queue.Pop() == &b);
+    REQUIRE(queue.Pop() == &c);
+    REQUIRE(queue.empty());
+  }
+
+  SECTION("preserves per-producer order across threads") {
+    const int producers = 4;
+    const int count = 10000;
+    node_webrtc::MpscQueue<TestNode> queue;
+    std::vector<std::vector<TestNode>> nodes(producers);
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; producer++) {
+      for (int sequence = 0; sequence < count; sequence++) {
+        nodes[producer].emplace_back(producer, sequence);
+      }
+    }
+    for (int producer = 0; producer < producers; producer++) {
+      threads.emplace_back([&queue, &nodes, producer]() {
+        for (auto& node : nodes[producer]) {
+          queue.Push(&node);
+        }
+      });
+    }
+    std::vector<int> last(producers, -1);
+    auto popped = 0;
+    auto ordered = true;
+    while (popped < producers * count) {
+      auto node = queue.Pop();
+      if (node) {
+        ordered = ordered && node->sequence == last[node->producer] + 1;
+        last[node->producer] = node->sequence;
+        popped++;
+      }
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(ordered);
+    REQUIRE(queue.empty());
+  }
+}
+
+TEST_CASE("LatestRing", "[latest-ring]") {
+  SECTION("pops nullptr when empty") {
+    node_webrtc::LatestRing<TestNode, 4> ring;
+    REQUIRE(ring.empty());
+    REQUIRE(ring.Pop() == nullptr);
+  }
+
+  SECTION("evicts the oldest nodes beyond the limit") {
+    node_webrtc::LatestRing<TestNode, 4> ring;
+    TestNode a(0, 0), b(0, 1), c(0, 2);
+    std::vector<TestNode*> evicted;
+    auto evict = [&evicted](TestNode* node) { evicted.push_back(node); };
+    ring.Push(&a, 2, evict);
+    ring.Push(&b, 2, evict);
+    ring.Push(&c, 2, evict);
+    REQUIRE(evicted == std::vector<TestNode*>({ &a }));
+    REQUIRE(ring.Pop() == &b);
+    REQUIRE(ring.Pop() == &c);
+    REQUIRE(ring.Pop() == nullptr);
+    REQUIRE(ring.empty());
+  }
+
+  SECTION("holds at most its capacity") {
+    node_webrtc::LatestRing<TestNode, 4> ring;
+    std::vector<TestNode> nodes;
+    for (int sequence = 0; sequence < 10; sequence++) {
+      nodes.emplace_back(0, sequence);
+    }
+    auto evicted = 0;
+    for (auto& node : nodes) {
+      ring.Push(&node, 0, [&evicted](TestNode*) { evicted++; });
+    }
+    REQUIRE(evicted == 6);
+    for (int sequence = 6; sequence < 10; sequence++) {
+      REQUIRE(ring.Pop() == &nodes[sequence]);
+    }
+    REQUIRE(ring.Pop() == nullptr);
+  }
+
+  SECTION("pops or evicts every node pushed across threads") {
+    const int producers = 4;
+    const int count = 10000;
+    node_webrtc::LatestRing<TestNode, 8> ring;
+    std::vector<std::vector<TestNode>> nodes(producers);
+    std::vector<std::thread> threads;
+    std::atomic<int> evicted = {0};
+    for (int producer = 0; producer < producers; producer++) {
+      for (int sequence = 0; sequence < count; sequence++) {
+        nodes[producer].emplace_back(producer, sequence);
+      }
+    }
+    for (int producer = 0; producer < producers; producer++) {
+      threads.emplace_back([&ring, &nodes, &evicted, producer]() {
+        for (auto& node : nodes[producer]) {
+          ring.Push(&node, 4, [&evicted](TestNode*) { evicted++; });
+        }
+      });
+    }
+    auto popped = 0;
+    while (popped + evicted < producers * count) {
+      if (ring.Pop()) {
+        popped++;
+      }
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(popped + evicted == producers * count);
+    REQUIRE(ring.Pop() == nullptr);
+  }
+}
+
+TEST_CASE("EventPool", "[event-pool]") {
+  SECTION("reuses memory deallocated on the same thread") {
+    auto first = node_webrtc::EventPool::Allocate(32);
+    node_webrtc::EventPool::Deallocate(first);
+    auto second = node_webrtc::EventPool::Allocate(32);
+    REQUIRE(first == second);
+    node_webrtc::EventPool::Deallocate(second);
+  }
+
+  SECTION("reuses memory deallocated on another thread") {
+    auto first = node_webrtc::EventPool::Allocate(32);
+    std::thread([first]() {
+      node_webrtc::EventPool::Deallocate(first);
+    }).join();
+    auto second = node_webrtc::EventPool::Allocate(32);
+    REQUIRE(first == second);
+    node_webrtc::EventPool::Deallocate(second);
+  }
+
+  SECTION("falls back to the global allocator for large sizes") {
+    auto pointer = node_webrtc::EventPool::Allocate(1 << 16);
+    REQUIRE(pointer != nullptr);
+    node_webrtc::EventPool::Deallocate(pointer);
+  }
+}
+
+TEST_CASE("SharedRingWriter", "[shared-ring]") {
+  using node_webrtc::SharedRingWriter;
+
+  alignas(uint32_t) uint8_t memory[SharedRingWriter::kHeaderSize + 32] = {};
+  auto header = reinterpret_cast<std::atomic<uint32_t>*>(memory);
+  auto data = memory + SharedRingWriter::kHeaderSize;
+  auto length = [data](size_t offset) {
+    uint32_t value;
+    memcpy(&value, data + offset, sizeof(value));
+    return value;
+  };
+  SharedRingWriter ring(memory, sizeof(memory));
+  const uint8_t payload[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  SECTION("writes length-prefixed, padded records") {
+    REQUIRE(ring.Write(payload, 3, true));
+    REQUIRE(ring.Write(payload, 1, false));
+    REQUIRE(length(0) == (3 | SharedRingWriter::kBinary));
+    REQUIRE(memcmp(data + 4, payload, 3) == 0);
+    REQUIRE(length(8) == 1);
+    REQUIRE(header[SharedRingWriter::kWriteOffset] == 16);
+  }
+
+  SECTION("leaves room to tell full from empty") {
+    REQUIRE(ring.Write(payload, 8, true));
+    REQUIRE(ring.Write(payload, 8, true));
+    REQUIRE(!ring.Write(payload, 4, true));
+    REQUIRE(ring.Write(payload, 0, true));
+    REQUIRE(!ring.Write(payload, 0, true));
+  }
+
+  SECTION("wraps once the reader catches up") {
+    REQUIRE(ring.Write(payload, 8, true));
+    REQUIRE(ring.Write(payload, 8, true));
+    header[SharedRingWriter::kReadOffset] = 24;
+    REQUIRE(ring.Write(payload, 10, true));
+    REQUIRE(length(24) == SharedRingWriter::kWrap);
+    REQUIRE(length(0) == (10 | SharedRingWriter::kBinary));
+    REQUIRE(header[SharedRingWriter::kWriteOffset] == 16);
+  }
+
+  SECTION("counts drops") {
+    ring.DidDrop();
+    REQUIRE(header[SharedRingWriter::kDropped] == 1);
+  }
+}
+
+TEST_CASE("DataChannelFraming", "[data-channel-framing]") {
+  using node_webrtc::DataChannelFraming;
+
+  std::vector<uint8_t> payload(3 * DataChannelFraming::kMaxFragmentSize + 5);
+  for (size_t i = 0; i < payload.size(); i++) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+  webrtc::DataBuffer message(rtc::CopyOnWriteBuffer(payload.data(), payload.size()), false);
+  std::vector<webrtc::DataBuffer> fragments;
+  DataChannelFraming::Fragment(message, &fragments);
+
+  SECTION("splits large messages into binary fragments") {
+    REQUIRE(fragments.size() == 4);
+    for (auto const& fragment : fragments) {
+      REQUIRE(fragment.binary);
+      REQUIRE(fragment.size() <= DataChannelFraming::kMaxFragmentSize);
+    }
+  }
+
+  SECTION("reassembles fragments into the original message") {
+    DataChannelFraming framing;
+    webrtc::DataBuffer reassembled("");
+    for (size_t i = 0; i < fragments.size(); i++) {
+      REQUIRE(framing.Reassemble(fragments[i], &reassembled) == (i + 1 == fragments.size()));
+    }
+    REQUIRE(!reassembled.binary);
+    REQUIRE(reassembled.size() == payload.size());
+    REQUIRE(memcmp(reassembled.data.cdata(), payload.data(), payload.size()) == 0);
+  }
+
+  SECTION("discards interrupted messages") {
+    DataChannelFraming framing;
+    webrtc::DataBuffer reassembled("");
+    REQUIRE(!framing.Reassemble(fragments[0], &reassembled));
+    REQUIRE(!framing.Reassemble(webrtc::DataBuffer("not a fragment"), &reassembled));
+    REQUIRE(!framing.Reassemble(fragments[1], &reassembled));
+  }
+
+  SECTION("discards messages larger than the limit") {
+    DataChannelFraming framing(payload.size() - 1);
+    webrtc::DataBuffer reassembled("");
+    for (auto const& fragment : fragments) {
+      REQUIRE(!framing.Reassemble(fragment, &reassembled));
+    }
+  }
+
+  SECTION("does not trust the declared size when allocating") {
+    DataChannelFraming framing;
+    webrtc::DataBuffer reassembled("");
+    const uint8_t first[] = { 1, 0x0f, 0xff, 0xff, 0xff, 'h', 'i' };
+    const uint8_t last[] = { 2, '!' };
+    REQUIRE(!framing.Reassemble(webrtc::DataBuffer(rtc::CopyOnWriteBuffer(first, sizeof(first)), true), &reassembled));
+    REQUIRE(framing.capacity() <= 4 * DataChannelFraming::kMaxFragmentSize);
+    REQUIRE(!framing.Reassemble(webrtc::DataBuffer(rtc::CopyOnWriteBuffer(last, sizeof(last)), true), &reassembled));
+    REQUIRE(framing.capacity() == 0);
+  }
+}
+
+TEST_CASE("DataChannelCompression", "[data-channel-compression]") {
+  using node_webrtc::DataChannelCompression;
+  using node_webrtc::DataChannelFraming;
+
+  SECTION("matches protocols that include it") {
+    REQUIRE(DataChannelCompression::IsEnabled("x-node-webrtc-deflate"));
+    REQUIRE(DataChannelCompression::IsEnabled("x-node-webrtc-fragmentation, x-node-webrtc-deflate"));
+    REQUIRE(!DataChannelCompression::IsEnabled("x-node-webrtc-deflate-2"));
+    REQUIRE(!DataChannelCompression::IsEnabled(""));
+  }
+
+  SECTION("compresses and decompresses repetitive messages") {
+    std::string text;
+    while (text.size() < 16 * 1024) {
+      text += "{\"hello\":\"world\"}";
+    }
+    webrtc::DataBuffer message(text);
+    auto compressed = DataChannelCompression::Compress(message, DataChannelCompression::kDefaultThreshold);
+    REQUIRE(compressed.size() < message.size() / 10);
+    webrtc::DataBuffer decompressed("");
+    REQUIRE(DataChannelCompression::Decompress(compressed, DataChannelFraming::kMaxMessageSize, &decompressed));
+    REQUIRE(!decompressed.binary);
+    REQUIRE(decompressed.size() == text.size());
+    REQUIRE(memcmp(decompressed.data.cdata(), text.data(), text.size()) == 0);
+  }
+
+  SECTION("sends small messages as they are") {
+    std::vector<uint8_t> payload(100, 1);
+    webrtc::DataBuffer message(rtc::CopyOnWriteBuffer(payload.data(), payload.size()), true);
+    auto compressed = DataChannelCompression::Compress(message, DataChannelCompression::kDefaultThreshold);
+    REQUIRE(compressed.size() == payload.size() + 1);
+    webrtc::DataBuffer decompressed("");
+    REQUIRE(DataChannelCompression::Decompress(compressed, DataChannelFraming::kMaxMessageSize, &decompressed));
+    REQUIRE(decompressed.binary);
+    REQUIRE(decompressed.size() == payload.size());
+  }
+
+  SECTION("rejects malformed messages") {
+    webrtc::DataBuffer decompressed("");
+    REQUIRE(!DataChannelCompression::Decompress(webrtc::DataBuffer(""), DataChannelFraming::kMaxMessageSize, &decompressed));
+    const uint8_t garbage[] = { 1, 0, 0, 1, 0, 'g', 'a', 'r', 'b', 'a', 'g', 'e' };
+    webrtc::DataBuffer message(rtc::CopyOnWriteBuffer(garbage, sizeof(garbage)), true);
+    REQUIRE(!DataChannelCompression::Decompress(message, DataChannelFraming::kMaxMessageSize, &decompressed));
+  }
+
+  SECTION("rejects messages whose declared size is wrong or too large") {
+    std::vector<uint8_t> payload(64 * 1024, 'x');
+    webrtc::DataBuffer message(rtc::CopyOnWriteBuffer(payload.data(), payload.size()), true);
+    auto compressed = DataChannelCompression::Compress(message, DataChannelCompression::kDefaultThreshold);
+    webrtc::DataBuffer decompressed("");
+    REQUIRE(!DataChannelCompression::Decompress(compressed, payload.size() - 1, &decompressed));
+    REQUIRE(DataChannelCompression::Decompress(compressed, payload.size(), &decompressed));
+
+    auto declare = [&compressed](uint32_t size) {
+      rtc::CopyOnWriteBuffer buffer(compressed.data.cdata(), compressed.size());
+      auto data = buffer.data();
+      data[1] = static_cast<uint8_t>(size >> 24);
+      data[2] = static_cast<uint8_t>(size >> 16);
+      data[3] = static_cast<uint8_t>(size >> 8);
+      data[4] = static_cast<uint8_t>(size);
+      return webrtc::DataBuffer(buffer, true);
+    };
+    REQUIRE(!DataChannelCompression::Decompress(declare(DataChannelFraming::kMaxMessageSize), DataChannelFraming::kMaxMessageSize, &decompressed));
+    REQUIRE(!DataChannelCompression::Decompress(declare(payload.size() + 1), DataChannelFraming::kMaxMessageSize, &decompressed));
+    REQUIRE(!DataChannelCompression::Decompress(declare(payload.size() - 1), DataChannelFraming::kMaxMessageSize, &decompressed));
+  }
+}
+
+TEST_CASE("FrameBufferPool", "[frame-buffer-pool]") {
+  using node_webrtc::FrameBufferPool;
+  using node_webrtc::PooledI420Buffer;
+
+  SECTION("recycles memory of the same bucket") {
+    FrameBufferPool pool;
+    auto first = pool.Acquire(1000);
+    auto data = first->data();
+    first = nullptr;
+    REQUIRE(pool.pooled_bytes() == FrameBufferPool::kBucketSize);
+    auto second = pool.Acquire(4000);
+    REQUIRE(second->data() == data);
+    REQUIRE(second->size() == 4000);
+    REQUIRE(pool.hits() == 1);
+    REQUIRE(pool.misses() == 1);
+    REQUIRE(pool.pooled_bytes() == 0);
+  }
+
+  SECTION("does not recycle memory of a different bucket") {
+    FrameBufferPool pool;
+    pool.Acquire(1000);
+    pool.Acquire(5000);
+    REQUIRE(pool.hits() == 0);
+    REQUIRE(pool.misses() == 2);
+  }
+
+  SECTION("keeps at most kMaxBuffersPerBucket") {
+    FrameBufferPool pool;
+    {
+      std::vector<rtc::scoped_refptr<node_webrtc::PooledMemory>> memory;
+      for (size_t i = 0; i < FrameBufferPool::kMaxBuffersPerBucket + 1; i++) {
+        memory.push_back(pool.Acquire(1));
+      }
+    }
+    REQUIRE(pool.pooled_bytes() == FrameBufferPool::kMaxBuffersPerBucket * FrameBufferPool::kBucketSize);
+  }
+
+  SECTION("lays out I420 planes contiguously") {
+    auto buffer = PooledI420Buffer::Create(161, 121);
+    REQUIRE(buffer->StrideY() == 161);
+    REQUIRE(buffer->StrideU() == 81);
+    REQUIRE(buffer->DataU() == buffer->DataY() + 161 * 121);
+    REQUIRE(buffer->DataV() == buffer->DataU() + 81 * 61);
+  }
+}
+
 NAN_METHOD(node_webrtc::Test::TestImpl) {
   auto result = Catch::Session().run();
   info.GetReturnValue().Set(result);
@@ -0,0 +1,139 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace node_webrtc {
+
+/**
+ * A LatestRing is a lock-free, multi-producer/single-consumer ring that holds
+ * only the most recently pushed nodes. Each push claims the next position with
+ * a single fetch-and-add and swaps its node into that position's slot; any node
+ * it displaces, or any node that falls more than a limit behind it, is evicted.
+ * The consumer swaps nodes out of the slots, oldest position first.
+ *
+ * The LatestRing does not own its nodes: evicted nodes are handed back to the
+ * producer that evicted them.
+ * @tparam T the node type
+ * @tparam N the number of slots
+ */
+template <typename T, size_t N>
+class LatestRing {
+ public:
+  /**
+   * The most nodes a LatestRing holds.
+   */
+  static constexpr size_t kCapacity = N;
+
+  /**
+   * Construct an empty LatestRing.
+   */
+  LatestRing() {
+    for (auto& slot : _slots) {
+      slot = nullptr;
+    }
+  }
+
+  LatestRing(LatestRing const&) = delete;
+
+  LatestRing& operator=(LatestRing const&) = delete;
+
+  /**
+   * Push a node, evicting nodes to hold no more than limit. This method may be
+   * called from any thread.
+   * @param node the node to push
+   * @param limit the most nodes to hold (zero, or more than kCapacity, means
+   *   kCapacity)
+   * @param evict called with each evicted node
+   */
+  template <typename F>
+  void Push(T* node, size_t limit, F evict) {
+    if (!limit || limit > N) {
+      limit = N;
+    }
+    while (node) {
+      auto position = _tail.fetch_add(1);
+      if (auto evicted = Slot(position).exchange(node)) {
+        evict(evicted);
+      }
+      if (limit < N && position >= limit) {
+        if (auto evicted = Slot(position - limit).exchange(nullptr)) {
+          evict(evicted);
+        }
+      }
+      // If the consumer moved past this position before the node was in its
+      // slot, it will not come back for it, so take the node back and push it
+      // again.
+      node = _head.load() > position ? Slot(position).exchange(nullptr) : nullptr;
+    }
+  }
+
+  /**
+   * Attempt to pop the oldest node. If the LatestRing is empty, this method
+   * returns nullptr. This method must only be called from the consumer thread.
+   * @return the popped node or nullptr
+   */
+  T* Pop() {
+    auto tail = _tail.load();
+    auto head = _head.load(std::memory_order_relaxed);
+    if (tail - head > N) {
+      head = tail - N;
+    }
+    while (head < tail) {
+      // Move past the position before emptying its slot, so that a producer
+      // still filling it notices (see Push).
+      _head.store(head + 1);
+      if (auto node = Slot(head).exchange(nullptr)) {
+        return node;
+      }
+      head++;
+    }
+    return nullptr;
+  }
+
+  /**
+   * Check whether the LatestRing is empty. This method must only be called from
+   * the consumer thread.
+   * @return true if the LatestRing is empty
+   */
+  bool empty() const {
+    return _head.load() >= _tail.load();
+  }
+
+  /**
+   * Remove every node, including any that Pop skipped. This method must only be
+   * called from the consumer thread, once no more nodes are pushed.
+   * @param evict called with each removed node
+   */
+  template <typename F>
+  void Clear(F evict) {
+    for (auto& slot : _slots) {
+      if (auto node = slot.exchange(nullptr)) {
+        evict(node);
+      }
+    }
+    _head.store(_tail.load());
+  }
+
+ private:
+  std::atomic<T*>& Slot(uint64_t position) {
+    return _slots[position % N];
+  }
+
+  std::atomic<T*> _slots[N];
+  std::atomic<uint64_t> _tail = {0};
+  std::atomic<uint64_t> _head = {0};
+};
+
+template <typename T, size_t N>
+constexpr size_t LatestRing<T, N>::kCapacity;
+
+}  // namespace node_webrtc
@@ -0,0 +1,105 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+
+namespace node_webrtc {
+
+template <typename T> class MpscQueue;
+
+/**
+ * MpscNode is the intrusive hook that allows a T to be linked into an
+ * MpscQueue<T>. T must derive from MpscNode<T>.
+ * @tparam T the node type
+ */
+template <typename T>
+class MpscNode {
+  friend class MpscQueue<T>;
+
+ private:
+  MpscNode<T>* _next = nullptr;
+};
+
+/**
+ * An MpscQueue is an intrusive, lock-free, multi-producer/single-consumer
+ * queue. Producers push with a single compare-and-swap. The consumer takes
+ * everything pushed so far with a single atomic exchange, and then pops from
+ * that batch without touching any shared state.
+ *
+ * The MpscQueue does not own its nodes.
+ * @tparam T the node type
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  /**
+   * Construct an empty MpscQueue.
+   */
+  MpscQueue() = default;
+
+  MpscQueue(MpscQueue const&) = delete;
+
+  MpscQueue& operator=(MpscQueue const&) = delete;
+
+  /**
+   * Push a node. This method may be called from any thread.
+   * @param node the node to push
+   */
+  void Push(T* node) {
+    MpscNode<T>* hook = node;
+    auto head = _head.load(std::memory_order_relaxed);
+    do {
+      hook->_next = head;
+    } while (!_head.compare_exchange_weak(head, hook, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  /**
+   * Attempt to pop a node in FIFO order. If the MpscQueue is empty, this method
+   * returns nullptr. This method must only be called from the consumer thread.
+   * @return the popped node or nullptr
+   */
+  T* Pop() {
+    if (!_batch) {
+      _batch = Reverse(_head.exchange(nullptr, std::memory_order_acquire));
+      if (!_batch) {
+        return nullptr;
+      }
+    }
+    auto hook = _batch;
+    _batch = hook->_next;
+    hook->_next = nullptr;
+    return static_cast<T*>(hook);
+  }
+
+  /**
+   * Check whether the MpscQueue is empty. This method must only be called from
+   * the consumer thread.
+   * @return true if the MpscQueue is empty
+   */
+  bool empty() const {
+    return !_batch && !_head.load(std::memory_order_acquire);
+  }
+
+ private:
+  static MpscNode<T>* Reverse(MpscNode<T>* list) {
+    MpscNode<T>* reversed = nullptr;
+    while (list) {
+      auto next = list->_next;
+      list->_next = reversed;
+      reversed = list;
+      list = next;
+    }
+    return reversed;
+  }
+
+  std::atomic<MpscNode<T>*> _head = {nullptr};
+  MpscNode<T>* _batch = nullptr;
+};
+
+}  // namespace node_webrtc
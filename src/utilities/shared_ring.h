@@ -0,0 +1,129 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace node_webrtc {
+
+/**
+ * A SharedRingWriter writes length-prefixed records into memory shared with a
+ * reader on another thread (in practice, a SharedArrayBuffer read from
+ * JavaScript with Atomics). There is exactly one writer and one reader.
+ *
+ * The memory starts with a header of four 32-bit words:
+ *
+ *   0. the write offset, advanced only by the writer
+ *   1. the read offset, advanced only by the reader
+ *   2. the number of records dropped because the ring was full
+ *   3. reserved
+ *
+ * followed by the data region. Offsets are relative to the data region. Each
+ * record is a 32-bit length (with kBinary set for binary records) followed by
+ * its payload, padded to a multiple of four bytes. A length of kWrap means the
+ * next record starts at the beginning of the data region. The ring is empty
+ * when the offsets are equal; the writer always leaves four bytes free, so that
+ * a full ring never looks empty.
+ */
+class SharedRingWriter {
+ public:
+  static constexpr size_t kWriteOffset = 0;
+  static constexpr size_t kReadOffset = 1;
+  static constexpr size_t kDropped = 2;
+  static constexpr size_t kHeaderSize = 4 * sizeof(uint32_t);
+  static constexpr uint32_t kBinary = 0x80000000;
+  static constexpr uint32_t kWrap = 0xffffffff;
+
+  /**
+   * Construct a SharedRingWriter over memory that outlives it. The memory must
+   * be at least kHeaderSize + 8 bytes and four-byte aligned. The header is
+   * reset, discarding anything already in the ring.
+   * @param memory the memory
+   * @param size the size of the memory, in bytes
+   */
+  SharedRingWriter(void* memory, size_t size)
+    : _header(static_cast<std::atomic<uint32_t>*>(memory))
+    , _data(static_cast<uint8_t*>(memory) + kHeaderSize)
+    , _capacity((size - kHeaderSize) & ~static_cast<size_t>(3)) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "std::atomic<uint32_t> must be 32 bits");
+    _header[kWriteOffset].store(0, std::memory_order_relaxed);
+    _header[kReadOffset].store(0, std::memory_order_relaxed);
+    _header[kDropped].store(0, std::memory_order_release);
+  }
+
+  SharedRingWriter(SharedRingWriter const&) = delete;
+
+  SharedRingWriter& operator=(SharedRingWriter const&) = delete;
+
+  /**
+   * Write a record, if there is room for it.
+   * @param data the payload
+   * @param size the size of the payload, in bytes
+   * @param binary whether the payload is binary
+   * @return false if the ring is full (or the record could never fit)
+   */
+  bool Write(const uint8_t* data, size_t size, bool binary) {
+    auto write = static_cast<size_t>(_header[kWriteOffset].load(std::memory_order_relaxed));
+    auto read = static_cast<size_t>(_header[kReadOffset].load(std::memory_order_acquire));
+    if (read >= _capacity || read % 4 || size >= kBinary) {
+      return false;
+    }
+    auto record = sizeof(uint32_t) + ((size + 3) & ~static_cast<size_t>(3));
+    auto free = read > write
+        ? read - write - 4
+        : _capacity - write + read - 4;
+    auto position = write;
+    auto needed = record;
+    if (_capacity - write < record) {
+      position = 0;
+      needed += _capacity - write;
+    }
+    if (needed > free) {
+      return false;
+    }
+    if (position != write) {
+      Store(write, kWrap);
+    }
+    Store(position, static_cast<uint32_t>(size) | (binary ? kBinary : 0));
+    if (size) {
+      memcpy(_data + position + sizeof(uint32_t), data, size);
+    }
+    auto next = position + record;
+    _header[kWriteOffset].store(static_cast<uint32_t>(next == _capacity ? 0 : next), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Record that a record was dropped.
+   */
+  void DidDrop() {
+    _header[kDropped].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Get the size of the data region.
+   * @return the capacity, in bytes
+   */
+  size_t capacity() const {
+    return _capacity;
+  }
+
+ private:
+  void Store(size_t position, uint32_t value) {
+    memcpy(_data + position, &value, sizeof(value));
+  }
+
+  std::atomic<uint32_t>* const _header;
+  uint8_t* const _data;
+  const size_t _capacity;
+};
+
+}  // namespace node_webrtc
@@ -0,0 +1,118 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/webrtc/converted_video_frame_buffer.h"
+
+#include <libyuv.h>
+#include <webrtc/rtc_base/ref_counted_object.h>
+
+namespace node_webrtc {
+
+ConvertedVideoFrameBuffer::ConvertedVideoFrameBuffer(VideoFrameFormat format, int width, int height)
+  : _format(format)
+  , _width(width)
+  , _height(height) {
+  if (format == VideoFrameFormat::kNV12) {
+    _stride = width;
+    _stride_uv = 2 * ((width + 1) / 2);
+    _offset_uv = static_cast<size_t>(_stride) * static_cast<size_t>(height);
+    _size = _offset_uv + static_cast<size_t>(_stride_uv) * static_cast<size_t>((height + 1) / 2);
+  } else {
+    _stride = 4 * width;
+    _size = static_cast<size_t>(_stride) * static_cast<size_t>(height);
+  }
+  _memory = FrameBufferPool::Default().Acquire(_size);
+}
+
+rtc::scoped_refptr<ConvertedVideoFrameBuffer> ConvertedVideoFrameBuffer::Create(
+    const webrtc::I420BufferInterface& buffer,
+    VideoFrameFormat format) {
+  rtc::scoped_refptr<ConvertedVideoFrameBuffer> converted(
+      new rtc::RefCountedObject<ConvertedVideoFrameBuffer>(format, buffer.width(), buffer.height()));
+  auto data = converted->_memory->data();
+  switch (format) {
+    case VideoFrameFormat::kRGBA:
+      // libyuv names formats by their word order, so its "ABGR" is RGBA in
+      // memory, and its "ARGB" is BGRA.
+      libyuv::I420ToABGR(
+          buffer.DataY(), buffer.StrideY(),
+          buffer.DataU(), buffer.StrideU(),
+          buffer.DataV(), buffer.StrideV(),
+          data, converted->_stride,
+          buffer.width(), buffer.height());
+      break;
+    case VideoFrameFormat::kBGRA:
+      libyuv::I420ToARGB(
+          buffer.DataY(), buffer.StrideY(),
+          buffer.DataU(), buffer.StrideU(),
+          buffer.DataV(), buffer.StrideV(),
+          data, converted->_stride,
+          buffer.width(), buffer.height());
+      break;
+    case VideoFrameFormat::kNV12:
+      libyuv::I420ToNV12(
+          buffer.DataY(), buffer.StrideY(),
+          buffer.DataU(), buffer.StrideU(),
+          buffer.DataV(), buffer.StrideV(),
+          data, converted->_stride,
+          data + converted->_offset_uv, converted->_stride_uv,
+          buffer.width(), buffer.height());
+      break;
+    case VideoFrameFormat::kI420:
+      break;
+  }
+  return converted;
+}
+
+webrtc::VideoFrameBuffer::Type ConvertedVideoFrameBuffer::type() const {
+  return Type::kNative;
+}
+
+int ConvertedVideoFrameBuffer::width() const {
+  return _width;
+}
+
+int ConvertedVideoFrameBuffer::height() const {
+  return _height;
+}
+
+rtc::scoped_refptr<webrtc::I420BufferInterface> ConvertedVideoFrameBuffer::ToI420() {
+  auto buffer = PooledI420Buffer::Create(_width, _height);
+  auto data = _memory->data();
+  switch (_format) {
+    case VideoFrameFormat::kRGBA:
+      libyuv::ABGRToI420(
+          data, _stride,
+          buffer->MutableDataY(), buffer->StrideY(),
+          buffer->MutableDataU(), buffer->StrideU(),
+          buffer->MutableDataV(), buffer->StrideV(),
+          _width, _height);
+      break;
+    case VideoFrameFormat::kBGRA:
+      libyuv::ARGBToI420(
+          data, _stride,
+          buffer->MutableDataY(), buffer->StrideY(),
+          buffer->MutableDataU(), buffer->StrideU(),
+          buffer->MutableDataV(), buffer->StrideV(),
+          _width, _height);
+      break;
+    case VideoFrameFormat::kNV12:
+      libyuv::NV12ToI420(
+          data, _stride,
+          data + _offset_uv, _stride_uv,
+          buffer->MutableDataY(), buffer->StrideY(),
+          buffer->MutableDataU(), buffer->StrideU(),
+          buffer->MutableDataV(), buffer->StrideV(),
+          _width, _height);
+      break;
+    case VideoFrameFormat::kI420:
+      break;
+  }
+  return buffer;
+}
+
+}  // namespace node_webrtc
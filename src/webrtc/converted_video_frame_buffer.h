@@ -0,0 +1,78 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <webrtc/api/scoped_refptr.h>
+#include <webrtc/api/video/video_frame_buffer.h>
+
+#include "src/enums/node_webrtc/video_frame_format.h"
+#include "src/webrtc/frame_buffer_pool.h"
+
+namespace webrtc { class I420BufferInterface; }
+
+namespace node_webrtc {
+
+/**
+ * ConvertedVideoFrameBuffer holds a frame converted out of I420 (for example,
+ * to RGBA), so that RTCVideoSink can convert frames before queueing them for
+ * JavaScript. WebRTC sees it as a kNative buffer, and converts it back with
+ * ToI420 if it has to.
+ *
+ * The planes are contiguous: RGBA and BGRA have one plane of four bytes per
+ * pixel; NV12 has a Y plane followed by an interleaved UV plane. The memory
+ * comes from FrameBufferPool::Default.
+ */
+class ConvertedVideoFrameBuffer : public webrtc::VideoFrameBuffer {
+ public:
+  /**
+   * Convert an I420 buffer.
+   * @param buffer the buffer
+   * @param format the format to convert to (not kI420)
+   * @return the converted buffer
+   */
+  static rtc::scoped_refptr<ConvertedVideoFrameBuffer> Create(const webrtc::I420BufferInterface& buffer, VideoFrameFormat format);
+
+  Type type() const override;
+
+  int width() const override;
+
+  int height() const override;
+
+  rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override;
+
+  VideoFrameFormat format() const { return _format; }
+
+  const uint8_t* data() const { return _memory->data(); }
+
+  size_t size() const { return _size; }
+
+  size_t number_of_planes() const { return _format == VideoFrameFormat::kNV12 ? 2 : 1; }
+
+  size_t offset(size_t plane) const { return plane ? _offset_uv : 0; }
+
+  int stride(size_t plane) const { return plane ? _stride_uv : _stride; }
+
+ protected:
+  ConvertedVideoFrameBuffer(VideoFrameFormat format, int width, int height);
+
+  ~ConvertedVideoFrameBuffer() override = default;
+
+ private:
+  const VideoFrameFormat _format;
+  const int _width;
+  const int _height;
+  int _stride;
+  int _stride_uv = 0;
+  size_t _offset_uv = 0;
+  size_t _size;
+  rtc::scoped_refptr<PooledMemory> _memory;
+};
+
+}  // namespace node_webrtc
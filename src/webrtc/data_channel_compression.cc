@@ -0,0 +1,194 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/webrtc/data_channel_compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <webrtc/rtc_base/copy_on_write_buffer.h>
+#include <webrtc/rtc_base/thread.h>
+#include <zlib.h>
+
+#include "src/webrtc/data_channel_framing.h"
+
+namespace node_webrtc {
+
+const char DataChannelCompression::kProtocol[] = "x-node-webrtc-deflate";
+
+constexpr size_t DataChannelCompression::kDefaultThreshold;
+
+namespace {
+
+constexpr uint8_t kUncompressed = 0;
+constexpr uint8_t kDeflated = 1;
+
+constexpr size_t kHeaderSize = 1 + 4;
+
+constexpr size_t kInflateChunkSize = 64 * 1024;
+
+/**
+ * Each thread keeps its z_streams, since initializing one allocates hundreds of
+ * kilobytes.
+ */
+class Streams {
+ public:
+  Streams() {
+    memset(&_deflate, 0, sizeof(_deflate));
+    memset(&_inflate, 0, sizeof(_inflate));
+    _deflate_ok = deflateInit2(&_deflate, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    _inflate_ok = inflateInit2(&_inflate, -MAX_WBITS) == Z_OK;
+  }
+
+  ~Streams() {
+    if (_deflate_ok) {
+      deflateEnd(&_deflate);
+    }
+    if (_inflate_ok) {
+      inflateEnd(&_inflate);
+    }
+  }
+
+  z_stream* deflater() {
+    return _deflate_ok && deflateReset(&_deflate) == Z_OK ? &_deflate : nullptr;
+  }
+
+  z_stream* inflater() {
+    return _inflate_ok && inflateReset(&_inflate) == Z_OK ? &_inflate : nullptr;
+  }
+
+ private:
+  z_stream _deflate;
+  z_stream _inflate;
+  bool _deflate_ok;
+  bool _inflate_ok;
+};
+
+Streams& streams() {
+  static thread_local Streams streams;
+  return streams;
+}
+
+webrtc::DataBuffer Uncompressed(const webrtc::DataBuffer& message) {
+  const uint8_t header[1] = { kUncompressed };
+  rtc::CopyOnWriteBuffer buffer;
+  buffer.EnsureCapacity(1 + message.size());
+  buffer.AppendData(header, 1);
+  buffer.AppendData(message.data.cdata(), message.size());
+  return webrtc::DataBuffer(buffer, message.binary);
+}
+
+}  // namespace
+
+bool DataChannelCompression::IsEnabled(const std::string& protocol) {
+  return HasProtocolExtension(protocol, kProtocol);
+}
+
+webrtc::DataBuffer DataChannelCompression::Compress(const webrtc::DataBuffer& message, size_t threshold) {
+  auto size = message.size();
+  if (size < threshold || size <= kHeaderSize || size > DataChannelFraming::kMaxMessageSize) {
+    return Uncompressed(message);
+  }
+  auto stream = streams().deflater();
+  if (!stream) {
+    return Uncompressed(message);
+  }
+
+  // Anything no smaller than the original is not worth sending.
+  rtc::CopyOnWriteBuffer buffer(size);
+  auto data = buffer.data();
+  data[0] = kDeflated;
+  data[1] = static_cast<uint8_t>(size >> 24);
+  data[2] = static_cast<uint8_t>(size >> 16);
+  data[3] = static_cast<uint8_t>(size >> 8);
+  data[4] = static_cast<uint8_t>(size);
+  stream->next_in = const_cast<Bytef*>(message.data.cdata());
+  stream->avail_in = static_cast<uInt>(size);
+  stream->next_out = data + kHeaderSize;
+  stream->avail_out = static_cast<uInt>(size - kHeaderSize);
+  if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+    return Uncompressed(message);
+  }
+  buffer.SetSize(kHeaderSize + stream->total_out);
+  return webrtc::DataBuffer(buffer, message.binary);
+}
+
+bool DataChannelCompression::Decompress(const webrtc::DataBuffer& message, size_t max_size, webrtc::DataBuffer* decompressed) {
+  auto data = message.data.cdata();
+  auto size = message.size();
+  if (!size) {
+    return false;
+  }
+  if (data[0] == kUncompressed) {
+    if (size - 1 > max_size) {
+      return false;
+    }
+    *decompressed = webrtc::DataBuffer(rtc::CopyOnWriteBuffer(data + 1, size - 1), message.binary);
+    return true;
+  }
+  if (data[0] != kDeflated || size < kHeaderSize) {
+    return false;
+  }
+
+  auto expected_size = static_cast<size_t>(data[1]) << 24
+      | static_cast<size_t>(data[2]) << 16
+      | static_cast<size_t>(data[3]) << 8
+      | static_cast<size_t>(data[4]);
+  if (expected_size > max_size) {
+    return false;
+  }
+  auto stream = streams().inflater();
+  if (!stream) {
+    return false;
+  }
+
+  // The declared size comes from the peer, so grow the buffer only as output
+  // is actually produced.
+  rtc::CopyOnWriteBuffer buffer;
+  buffer.EnsureCapacity(std::min(expected_size, kInflateChunkSize));
+  stream->next_in = const_cast<Bytef*>(data + kHeaderSize);
+  stream->avail_in = static_cast<uInt>(size - kHeaderSize);
+  auto result = Z_OK;
+  while (result == Z_OK) {
+    auto offset = buffer.size();
+    if (offset == expected_size) {
+      // The stream must end here; any further output means the size was wrong.
+      uint8_t extra;
+      stream->next_out = &extra;
+      stream->avail_out = 1;
+      result = inflate(stream, Z_FINISH);
+      if (!stream->avail_out) {
+        return false;
+      }
+      break;
+    }
+    auto chunk = std::min(expected_size - offset, kInflateChunkSize);
+    buffer.SetSize(offset + chunk);
+    stream->next_out = buffer.data() + offset;
+    stream->avail_out = static_cast<uInt>(chunk);
+    result = inflate(stream, Z_NO_FLUSH);
+    buffer.SetSize(offset + chunk - stream->avail_out);
+  }
+  if (result != Z_STREAM_END || buffer.size() != expected_size) {
+    return false;
+  }
+  *decompressed = webrtc::DataBuffer(buffer, message.binary);
+  return true;
+}
+
+rtc::Thread* DataChannelCompression::thread() {
+  static rtc::Thread* thread = [] {
+    auto thread = rtc::Thread::Create().release();
+    thread->SetName("node-webrtc compression", nullptr);
+    thread->Start();
+    return thread;
+  }();
+  return thread;
+}
+
+}  // namespace node_webrtc
@@ -0,0 +1,79 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <webrtc/api/data_channel_interface.h>
+
+namespace rtc {
+
+class Thread;
+
+}  // namespace rtc
+
+namespace node_webrtc {
+
+/**
+ * DataChannelCompression deflates RTCDataChannel messages. Both ends opt in by
+ * including kProtocol in the RTCDataChannel's protocol. Every message then
+ * starts with a byte saying whether it is compressed; compressed messages
+ * follow it with their decompressed size (32-bit, big-endian) and a raw
+ * deflate stream. Messages below a threshold, or that would not shrink, are
+ * sent as they are.
+ *
+ * Compression composes with DataChannelFraming: messages are compressed, then
+ * fragmented, and reassembled, then decompressed.
+ */
+class DataChannelCompression {
+ public:
+  static const char kProtocol[];
+
+  /**
+   * Messages smaller than this are not compressed by default.
+   */
+  static constexpr size_t kDefaultThreshold = 1024;
+
+  /**
+   * Check whether an RTCDataChannel's protocol enables DataChannelCompression.
+   * @param protocol the protocol
+   * @return true if enabled
+   */
+  static bool IsEnabled(const std::string& protocol);
+
+  /**
+   * Compress a message. This method may be called from any thread.
+   * @param message the message
+   * @param threshold the size below which not to bother
+   * @return the (possibly) compressed message
+   */
+  static webrtc::DataBuffer Compress(const webrtc::DataBuffer& message, size_t threshold);
+
+  /**
+   * Decompress a message. The declared size is checked against max_size before
+   * anything is allocated, and the message is inflated a chunk at a time, so a
+   * peer cannot make it allocate more than it actually sends. This method may
+   * be called from any thread.
+   * @param message the message
+   * @param max_size the largest decompressed message to accept
+   * @param decompressed the decompressed message
+   * @return false if the message was malformed or too large
+   */
+  static bool Decompress(const webrtc::DataBuffer& message, size_t max_size, webrtc::DataBuffer* decompressed);
+
+  /**
+   * Get the thread that compresses outgoing messages for every RTCDataChannel,
+   * so that neither the JavaScript thread nor the signaling thread pays for
+   * it. The thread is started on first use and never stopped.
+   * @return the thread
+   */
+  static rtc::Thread* thread();
+};
+
+}  // namespace node_webrtc
@@ -0,0 +1,163 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/webrtc/data_channel_framing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace node_webrtc {
+
+const char DataChannelFraming::kProtocol[] = "x-node-webrtc-fragmentation";
+
+constexpr size_t DataChannelFraming::kMaxFragmentSize;
+constexpr size_t DataChannelFraming::kMaxMessageSize;
+
+namespace {
+
+constexpr uint8_t kFirst = 1;
+constexpr uint8_t kLast = 2;
+constexpr uint8_t kText = 4;
+
+constexpr size_t kSizeOfSize = 4;
+
+// The declared size comes from the peer, so reserve no more than a few
+// fragments' worth up front; the buffer grows as the rest arrive.
+constexpr size_t kMaxInitialCapacity = 4 * DataChannelFraming::kMaxFragmentSize;
+
+}  // namespace
+
+bool HasProtocolExtension(const std::string& protocol, const char* extension) {
+  auto length = strlen(extension);
+  size_t start = 0;
+  while (start <= protocol.size()) {
+    auto end = std::min(protocol.find(',', start), protocol.size());
+    auto first = protocol.find_first_not_of(' ', start);
+    auto last = end;
+    while (last > start && protocol[last - 1] == ' ') {
+      last--;
+    }
+    if (first < last && last - first == length && protocol.compare(first, length, extension) == 0) {
+      return true;
+    }
+    start = end + 1;
+  }
+  return false;
+}
+
+void DataChannelFraming::Fragment(const webrtc::DataBuffer& message, std::vector<webrtc::DataBuffer>* fragments) {
+  auto data = message.data.cdata();
+  auto size = message.size();
+  uint8_t text = message.binary ? 0 : kText;
+
+  if (size + 1 <= kMaxFragmentSize) {
+    const uint8_t header[1] = { static_cast<uint8_t>(kFirst | kLast | text) };
+    rtc::CopyOnWriteBuffer fragment;
+    fragment.EnsureCapacity(size + 1);
+    fragment.AppendData(header, 1);
+    fragment.AppendData(data, size);
+    fragments->emplace_back(fragment, true);
+    return;
+  }
+
+  size_t offset = 0;
+  while (offset < size) {
+    auto first = offset == 0;
+    auto header_size = first ? 1 + kSizeOfSize : 1;
+    auto payload_size = std::min(size - offset, kMaxFragmentSize - header_size);
+    auto last = offset + payload_size == size;
+    auto total = static_cast<uint32_t>(size);
+    const uint8_t header[1 + kSizeOfSize] = {
+      static_cast<uint8_t>((first ? kFirst : 0) | (last ? kLast : 0) | text),
+      static_cast<uint8_t>(total >> 24),
+      static_cast<uint8_t>(total >> 16),
+      static_cast<uint8_t>(total >> 8),
+      static_cast<uint8_t>(total)
+    };
+    rtc::CopyOnWriteBuffer fragment;
+    fragment.EnsureCapacity(header_size + payload_size);
+    fragment.AppendData(header, header_size);
+    fragment.AppendData(data + offset, payload_size);
+    fragments->emplace_back(fragment, true);
+    offset += payload_size;
+  }
+}
+
+bool DataChannelFraming::Reassemble(const webrtc::DataBuffer& fragment, webrtc::DataBuffer* message) {
+  auto data = fragment.data.cdata();
+  auto size = fragment.size();
+  if (!fragment.binary || !size) {
+    Reset();
+    return false;
+  }
+
+  auto flags = data[0];
+  auto first = (flags & kFirst) != 0;
+  auto last = (flags & kLast) != 0;
+  auto binary = (flags & kText) == 0;
+
+  if (first && last) {
+    Reset();
+    *message = webrtc::DataBuffer(rtc::CopyOnWriteBuffer(data + 1, size - 1), binary);
+    return true;
+  }
+
+  if (first) {
+    Reset();
+    if (size < 1 + kSizeOfSize) {
+      return false;
+    }
+    _expected_size = static_cast<size_t>(data[1]) << 24
+        | static_cast<size_t>(data[2]) << 16
+        | static_cast<size_t>(data[3]) << 8
+        | static_cast<size_t>(data[4]);
+    if (_expected_size > _max_message_size) {
+      return false;
+    }
+    _buffer = rtc::CopyOnWriteBuffer();
+    _buffer.EnsureCapacity(std::min(_expected_size, kMaxInitialCapacity));
+    _binary = binary;
+    _in_progress = true;
+    data += 1 + kSizeOfSize;
+    size -= 1 + kSizeOfSize;
+  } else {
+    if (!_in_progress || binary != _binary) {
+      Reset();
+      return false;
+    }
+    data += 1;
+    size -= 1;
+  }
+
+  if (_buffer.size() + size > _expected_size) {
+    Reset();
+    return false;
+  }
+  _buffer.AppendData(data, size);
+
+  if (!last) {
+    return false;
+  }
+  if (_buffer.size() != _expected_size) {
+    Reset();
+    return false;
+  }
+  *message = webrtc::DataBuffer(std::move(_buffer), _binary);
+  Reset();
+  return true;
+}
+
+void DataChannelFraming::Reset() {
+  _buffer = rtc::CopyOnWriteBuffer();
+  _expected_size = 0;
+  _binary = true;
+  _in_progress = false;
+}
+
+}  // namespace node_webrtc
@@ -0,0 +1,108 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <webrtc/api/data_channel_interface.h>
+#include <webrtc/rtc_base/copy_on_write_buffer.h>
+
+namespace node_webrtc {
+
+/**
+ * Check whether an RTCDataChannel's protocol includes an extension. The
+ * protocol may list several extensions, separated by commas.
+ * @param protocol the protocol
+ * @param extension the extension
+ * @return true if included
+ */
+bool HasProtocolExtension(const std::string& protocol, const char* extension);
+
+/**
+ * DataChannelFraming lets RTCDataChannels send messages larger than SCTP
+ * allows. Both ends opt in by including kProtocol in the RTCDataChannel's
+ * protocol. Every message is then sent as one or more binary fragments, each
+ * starting with a flags byte; the first fragment of a multi-fragment message
+ * also carries the message's total size (32-bit, big-endian), so that the
+ * receiver can check it against its limit before buffering anything.
+ *
+ * Fragmentation requires an ordered, reliable RTCDataChannel.
+ */
+class DataChannelFraming {
+ public:
+  static const char kProtocol[];
+
+  /**
+   * The largest fragment sent, including its header.
+   */
+  static constexpr size_t kMaxFragmentSize = 64 * 1024;
+
+  /**
+   * The largest message reassembled by default. Larger messages are discarded.
+   */
+  static constexpr size_t kMaxMessageSize = 256 * 1024 * 1024;
+
+  /**
+   * @param max_message_size the largest message to reassemble
+   */
+  explicit DataChannelFraming(size_t max_message_size = kMaxMessageSize)
+    : _max_message_size(max_message_size) {}
+
+  /**
+   * Check whether an RTCDataChannel's protocol enables DataChannelFraming.
+   * @param protocol the protocol
+   * @return true if enabled
+   */
+  static bool IsEnabled(const std::string& protocol) {
+    return HasProtocolExtension(protocol, kProtocol);
+  }
+
+  /**
+   * Split a message into fragments.
+   * @param message the message
+   * @param fragments the fragments are appended here
+   */
+  static void Fragment(const webrtc::DataBuffer& message, std::vector<webrtc::DataBuffer>* fragments);
+
+  /**
+   * Add a received fragment. Fragments that do not follow the framing are
+   * discarded, along with any message they interrupt.
+   * @param fragment the fragment
+   * @param message the message, once complete
+   * @return true if fragment completed a message
+   */
+  bool Reassemble(const webrtc::DataBuffer& fragment, webrtc::DataBuffer* message);
+
+  /**
+   * Change the largest message to reassemble. Messages already in progress
+   * keep the limit they started with.
+   * @param max_message_size the largest message to reassemble
+   */
+  void set_max_message_size(size_t max_message_size) { _max_message_size = max_message_size; }
+  size_t max_message_size() const { return _max_message_size; }
+
+  /**
+   * @return the memory held for the message in progress
+   */
+  size_t capacity() const { return _buffer.capacity(); }
+
+ private:
+  void Reset();
+
+  std::atomic<size_t> _max_message_size;
+
+  rtc::CopyOnWriteBuffer _buffer;
+  size_t _expected_size = 0;
+  bool _binary = true;
+  bool _in_progress = false;
+};
+
+}  // namespace node_webrtc
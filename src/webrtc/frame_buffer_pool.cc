@@ -0,0 +1,74 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#include "src/webrtc/frame_buffer_pool.h"
+
+#include <utility>
+
+#include <webrtc/rtc_base/ref_counted_object.h>
+
+namespace node_webrtc {
+
+constexpr size_t FrameBufferPool::kBucketSize;
+constexpr size_t FrameBufferPool::kMaxBuffersPerBucket;
+constexpr size_t FrameBufferPool::kMaxPooledBytes;
+
+// Matches webrtc::I420Buffer, so that libyuv can use SIMD.
+static constexpr size_t kAlignment = 64;
+
+PooledMemory::~PooledMemory() {
+  _pool.Return(std::move(_data), _capacity);
+}
+
+FrameBufferPool& FrameBufferPool::Default() {
+  static auto pool = new FrameBufferPool();
+  return *pool;
+}
+
+rtc::scoped_refptr<PooledMemory> FrameBufferPool::Acquire(size_t size) {
+  auto capacity = size ? (size + kBucketSize - 1) / kBucketSize * kBucketSize : kBucketSize;
+  std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> data;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto bucket = _buckets.find(capacity);
+    if (bucket != _buckets.end() && !bucket->second.empty()) {
+      data = std::move(bucket->second.back());
+      bucket->second.pop_back();
+      _pooled_bytes -= capacity;
+    }
+  }
+  if (data) {
+    _hits++;
+  } else {
+    _misses++;
+    data.reset(static_cast<uint8_t*>(webrtc::AlignedMalloc(capacity, kAlignment)));
+  }
+  return new rtc::RefCountedObject<PooledMemory>(*this, std::move(data), size, capacity);
+}
+
+size_t FrameBufferPool::pooled_bytes() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _pooled_bytes;
+}
+
+void FrameBufferPool::Return(std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> data, size_t capacity) {
+  std::lock_guard<std::mutex> lock(_lock);
+  auto& bucket = _buckets[capacity];
+  if (bucket.size() < kMaxBuffersPerBucket && _pooled_bytes + capacity <= kMaxPooledBytes) {
+    bucket.push_back(std::move(data));
+    _pooled_bytes += capacity;
+  }
+}
+
+rtc::scoped_refptr<PooledI420Buffer> PooledI420Buffer::Create(int width, int height) {
+  auto chromaHeight = static_cast<size_t>((height + 1) / 2);
+  auto chromaWidth = static_cast<size_t>((width + 1) / 2);
+  auto size = static_cast<size_t>(width) * static_cast<size_t>(height) + 2 * chromaWidth * chromaHeight;
+  return new rtc::RefCountedObject<PooledI420Buffer>(width, height, FrameBufferPool::Default().Acquire(size));
+}
+
+}  // namespace node_webrtc
@@ -0,0 +1,163 @@
+/* Copyright (c) 2019 The node-webrtc project authors. All rights reserved.
+ *
+ * Use of this source code is governed by a BSD-style license that can be found
+ * in the LICENSE.md file in the root of the source tree. All contributing
+ * project authors may be found in the AUTHORS file in the root of the source
+ * tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <webrtc/api/scoped_refptr.h>
+#include <webrtc/api/video/video_frame_buffer.h>
+#include <webrtc/rtc_base/memory/aligned_malloc.h>
+#include <webrtc/rtc_base/ref_count.h>
+
+namespace node_webrtc {
+
+class FrameBufferPool;
+
+/**
+ * PooledMemory is memory borrowed from a FrameBufferPool. It goes back to the
+ * FrameBufferPool once the last reference to it is released, from whichever
+ * thread that happens on.
+ */
+class PooledMemory : public rtc::RefCountInterface {
+  friend class FrameBufferPool;
+
+ public:
+  uint8_t* data() const { return _data.get(); }
+
+  size_t size() const { return _size; }
+
+ protected:
+  PooledMemory(FrameBufferPool& pool, std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> data, size_t size, size_t capacity)
+    : _pool(pool)
+    , _data(std::move(data))
+    , _size(size)
+    , _capacity(capacity) {}
+
+  ~PooledMemory() override;
+
+ private:
+  FrameBufferPool& _pool;
+  std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> _data;
+  const size_t _size;
+  const size_t _capacity;
+};
+
+/**
+ * FrameBufferPool recycles the memory behind video frames, so that sources and
+ * sinks producing frames of the same size at 30-60 fps do not allocate (and,
+ * once JavaScript holds them, garbage collect) a new buffer every time. Free
+ * memory is kept in buckets by size, rounded up to kBucketSize; each bucket
+ * keeps at most kMaxBuffersPerBucket, and the pool keeps at most
+ * kMaxPooledBytes altogether. Anything over is freed.
+ */
+class FrameBufferPool {
+  friend class PooledMemory;
+
+ public:
+  static constexpr size_t kBucketSize = 4096;
+  static constexpr size_t kMaxBuffersPerBucket = 8;
+  static constexpr size_t kMaxPooledBytes = 128 * 1024 * 1024;
+
+  FrameBufferPool() = default;
+
+  FrameBufferPool(FrameBufferPool const&) = delete;
+
+  FrameBufferPool& operator=(FrameBufferPool const&) = delete;
+
+  /**
+   * Get the FrameBufferPool shared by every RTCVideoSink and RTCVideoSource,
+   * on every thread. It is never deleted, since PooledMemory may outlive
+   * everything else.
+   * @return the FrameBufferPool
+   */
+  static FrameBufferPool& Default();
+
+  /**
+   * Borrow memory. This method may be called from any thread.
+   * @param size the size of the memory, in bytes
+   * @return the memory
+   */
+  rtc::scoped_refptr<PooledMemory> Acquire(size_t size);
+
+  uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+
+  uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+
+  /**
+   * Get the amount of free memory the FrameBufferPool holds.
+   * @return the size of the free memory, in bytes
+   */
+  size_t pooled_bytes() const;
+
+ private:
+  void Return(std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> data, size_t capacity);
+
+  mutable std::mutex _lock;
+  std::unordered_map<size_t, std::vector<std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter>>> _buckets;
+  size_t _pooled_bytes = 0;
+  std::atomic<uint64_t> _hits = {0};
+  std::atomic<uint64_t> _misses = {0};
+};
+
+/**
+ * PooledI420Buffer is an I420 buffer in PooledMemory. Like webrtc::I420Buffer,
+ * its planes are contiguous and its strides are as small as possible.
+ */
+class PooledI420Buffer : public webrtc::I420BufferInterface {
+ public:
+  /**
+   * Create a PooledI420Buffer in FrameBufferPool::Default.
+   * @param width the width
+   * @param height the height
+   * @return the PooledI420Buffer, whose contents are undefined
+   */
+  static rtc::scoped_refptr<PooledI420Buffer> Create(int width, int height);
+
+  int width() const override { return _width; }
+
+  int height() const override { return _height; }
+
+  const uint8_t* DataY() const override { return _memory->data(); }
+
+  const uint8_t* DataU() const override { return DataY() + StrideY() * _height; }
+
+  const uint8_t* DataV() const override { return DataU() + StrideU() * ChromaHeight(); }
+
+  int StrideY() const override { return _width; }
+
+  int StrideU() const override { return (_width + 1) / 2; }
+
+  int StrideV() const override { return (_width + 1) / 2; }
+
+  uint8_t* MutableDataY() { return const_cast<uint8_t*>(DataY()); }
+
+  uint8_t* MutableDataU() { return const_cast<uint8_t*>(DataU()); }
+
+  uint8_t* MutableDataV() { return const_cast<uint8_t*>(DataV()); }
+
+ protected:
+  PooledI420Buffer(int width, int height, rtc::scoped_refptr<PooledMemory> memory)
+    : _width(width)
+    , _height(height)
+    , _memory(std::move(memory)) {}
+
+  ~PooledI420Buffer() override = default;
+
+ private:
+  const int _width;
+  const int _height;
+  const rtc::scoped_refptr<PooledMemory> _memory;
+};
+
+}  // namespace node_webrtc
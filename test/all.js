@@ -7,6 +7,7 @@ require('./closing-data-channel');
 require('./closing-peer-connection');
 require('./connect');
 require('./create-offer');
+require('./eventloop');
 require('./get-configuration');
 require('./i420helpers');
 require('./iceservers');
@@ -28,6 +29,7 @@ require('./sessiondesc');
 // Therefore, we skip them. Remove this if-statement once we drop support for
 // Node 6.
 if (semver(process.version).major > 6) {
+  require('./rtcdatachannel-nonstandard');
   require('./rtcvideosource');
 }
 
@@ -49,3 +51,8 @@ if (semver(process.version).major > 6) {
 if (semver(process.version).major >= 9 && typeof gc === 'function') {
   require('./destructor');
 }
+
+// worker_threads are available without a flag since Node 11.7.
+if (semver.gte(process.version, '11.7.0')) {
+  require('./worker-threads');
+}
@@ -0,0 +1,186 @@
+'use strict';
+
+const tape = require('tape');
+
+const { RTCPeerConnection } = require('..');
+
+const {
+  getEventLoopBudget,
+  getEventLoopMetrics,
+  getFastCallbacks,
+  setEventLoopBudget,
+  setFastCallbacks,
+  RTCVideoSink,
+  RTCVideoSource
+} = require('..').nonstandard;
+
+const { I420Frame } = require('./lib/frame');
+
+const candidate = {
+  candidate: 'candidate:559267639 1 udp 2122267903 ::1 57693 typ host generation 0 ufrag ZVjA network-id 2',
+  sdpMid: '0',
+  sdpMLineIndex: 0
+};
+
+tape('getEventLoopBudget() defaults to an unlimited budget', t => {
+  t.deepEqual(getEventLoopBudget(), { maxEvents: 0, maxTime: 0 });
+  t.end();
+});
+
+tape('setEventLoopBudget(budget) updates only the limits provided', t => {
+  setEventLoopBudget({ maxEvents: 10 });
+  t.deepEqual(getEventLoopBudget(), { maxEvents: 10, maxTime: 0 });
+  setEventLoopBudget({ maxTime: 5000 });
+  t.deepEqual(getEventLoopBudget(), { maxEvents: 10, maxTime: 5000 });
+  setEventLoopBudget({ maxEvents: 0, maxTime: 0 });
+  t.deepEqual(getEventLoopBudget(), { maxEvents: 0, maxTime: 0 });
+  t.end();
+});
+
+tape('setEventLoopBudget() throws a TypeError without a budget', t => {
+  t.throws(() => setEventLoopBudget(), TypeError);
+  t.end();
+});
+
+tape('a budget of maxEvents yields to the libuv loop between events', t => {
+  const numberOfFrames = 10;
+  setEventLoopBudget({ maxEvents: 1 });
+
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+
+  let framesReceived = 0;
+  let framesReceivedBeforeImmediate = null;
+
+  const allFramesReceived = new Promise(resolve => {
+    sink.onframe = () => {
+      if (++framesReceived === numberOfFrames) {
+        resolve();
+      }
+    };
+  });
+
+  for (let i = 0; i < numberOfFrames; i++) {
+    source.onFrame(new I420Frame(160, 120));
+  }
+  setImmediate(() => { framesReceivedBeforeImmediate = framesReceived; });
+
+  return allFramesReceived.then(() => {
+    t.ok(framesReceivedBeforeImmediate < numberOfFrames,
+      'setImmediate ran before every frame was dispatched');
+    t.equal(framesReceived, numberOfFrames, 'every frame was dispatched');
+    sink.stop();
+    track.stop();
+    setEventLoopBudget({ maxEvents: 0, maxTime: 0 });
+    t.end();
+  });
+});
+
+tape('control events are dispatched before queued bulk events', t => {
+  const numberOfFrames = 1000;
+  setEventLoopBudget({ maxEvents: 1 });
+
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  const pc = new RTCPeerConnection();
+  pc.createDataChannel('test');
+
+  let framesReceived = 0;
+  sink.onframe = () => { framesReceived++; };
+
+  for (let i = 0; i < numberOfFrames; i++) {
+    source.onFrame(new I420Frame(2, 2));
+  }
+
+  return pc.createOffer().then(() => {
+    t.ok(framesReceived < numberOfFrames, 'createOffer resolved before every frame was dispatched');
+    sink.stop();
+    track.stop();
+    pc.close();
+    setEventLoopBudget({ maxEvents: 0, maxTime: 0 });
+    t.end();
+  });
+});
+
+tape('promises settled in one wakeup all settle before any of their reactions run', t => {
+  // Neither RTCPeerConnection has a remote description, so both
+  // addIceCandidate calls reject as soon as their EventLoops run.
+  const pc1 = new RTCPeerConnection();
+  const pc2 = new RTCPeerConnection();
+  const promise1 = pc1.addIceCandidate(candidate);
+  const promise2 = pc2.addIceCandidate(candidate);
+
+  // If promise2 had not settled yet, the already-resolved Promise would win.
+  return promise1.catch(() => Promise.race([promise2, Promise.resolve('pending')])).then(() => {
+    t.fail('a microtask checkpoint ran between the two EventLoops');
+  }, () => {
+    t.pass('both promises settled before the first reaction ran');
+  }).then(() => {
+    pc1.close();
+    pc2.close();
+    t.end();
+  });
+});
+
+tape('getEventLoopMetrics() reports metrics per object class', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  const before = getEventLoopMetrics().RTCVideoSink;
+  const eventsDispatchedBefore = before ? before.eventsDispatched : 0;
+
+  const frameReceived = new Promise(resolve => { sink.onframe = resolve; });
+  source.onFrame(new I420Frame(160, 120));
+
+  return frameReceived.then(() => {
+    const metrics = getEventLoopMetrics().RTCVideoSink;
+    t.ok(metrics.eventsDispatched > eventsDispatchedBefore, 'eventsDispatched increases');
+    t.ok(metrics.peakQueueDepth >= 1, 'peakQueueDepth is at least one');
+    t.equal(typeof metrics.queueDepth, 'number', 'queueDepth is a number');
+    ['count', 'min', 'max', 'mean', 'p50', 'p90', 'p99', 'p999'].forEach(key => {
+      t.equal(typeof metrics.latency[key], 'number', `latency.${key} is a number`);
+    });
+    t.ok(metrics.latency.p50 <= metrics.latency.max, 'latency.p50 is at most latency.max');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});
+
+tape('getFastCallbacks() defaults to false', t => {
+  t.equal(getFastCallbacks(), false);
+  t.end();
+});
+
+tape('setFastCallbacks(enabled) toggles fast callbacks', t => {
+  setFastCallbacks(true);
+  t.equal(getFastCallbacks(), true);
+  setFastCallbacks(false);
+  t.equal(getFastCallbacks(), false);
+  t.end();
+});
+
+tape('with fast callbacks, nextTicks and microtasks scheduled by callbacks still run', t => {
+  setFastCallbacks(true);
+
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+
+  const ticked = new Promise(resolve => {
+    sink.onframe = () => {
+      process.nextTick(() => Promise.resolve().then(resolve));
+    };
+  });
+  source.onFrame(new I420Frame(160, 120));
+
+  return ticked.then(() => {
+    t.pass('the nextTick and the microtask ran');
+    sink.stop();
+    track.stop();
+    setFastCallbacks(false);
+    t.end();
+  });
+});
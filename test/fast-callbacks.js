@@ -0,0 +1,66 @@
+'use strict';
+
+const { performance } = require('perf_hooks');
+const tape = require('tape');
+
+const {
+  RTCVideoSink,
+  RTCVideoSource,
+  setFastCallbacks
+} = require('..').nonstandard;
+
+const { I420Frame } = require('./lib/frame');
+
+// Frames are tiny, so that the cost of making the callback
+// dominates the cost of converting the frame.
+async function measureTimePerCallback(fastCallbacks, n) {
+  n = typeof n === 'number' ? n : 10000;
+
+  setFastCallbacks(fastCallbacks);
+
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  const frame = new I420Frame(2, 2);
+
+  try {
+    let framesReceived = 0;
+    const allFramesReceived = new Promise(resolve => {
+      sink.onframe = () => {
+        if (++framesReceived === n) {
+          resolve(performance.now());
+        }
+      };
+    });
+
+    const start = performance.now();
+    for (let i = 0; i < n; i++) {
+      source.onFrame(frame);
+    }
+    const end = await allFramesReceived;
+
+    return (end - start) * 1000 / n;
+  } catch (error) {
+    throw error;
+  } finally {
+    sink.stop();
+    track.stop();
+    setFastCallbacks(false);
+  }
+}
+
+function testTimePerCallback(t, fastCallbacks) {
+  t.test(`Average Time per RTCVideoSink Callback (fast callbacks ${fastCallbacks ? 'enabled' : 'disabled'})`, async t => {
+    // Warm up.
+    await measureTimePerCallback(fastCallbacks, 1000);
+    const averageTime = await measureTimePerCallback(fastCallbacks);
+    console.log(`#
+#  ${averageTime} μs
+#
+`);
+    t.end();
+  });
+}
+
+testTimePerCallback(tape, false);
+testTimePerCallback(tape, true);
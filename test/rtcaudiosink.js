@@ -3,7 +3,7 @@
 const test = require('tape');
 
 const { getUserMedia } = require('..');
-const { RTCAudioSink } = require('..').nonstandard;
+const { RTCAudioSink, RTCAudioSource } = require('..').nonstandard;
 
 test('RTCAudioSink', t => {
   return getUserMedia({ audio: true }).then(stream => {
@@ -16,3 +16,17 @@ test('RTCAudioSink', t => {
     t.end();
   });
 });
+
+test('RTCAudioSink has a highWaterMark and counts dropped data', t => {
+  const source = new RTCAudioSource();
+  const track = source.createTrack();
+  const sink = new RTCAudioSink(track);
+  t.equal(sink.highWaterMark, 0, 'highWaterMark defaults to 0 (unlimited)');
+  t.equal(sink.dataDropped, 0, 'dataDropped is initially 0');
+  sink.highWaterMark = 10;
+  t.equal(sink.highWaterMark, 10, 'highWaterMark can be set');
+  t.throws(() => { sink.highWaterMark = 'foo'; }, TypeError, 'highWaterMark must be a number');
+  sink.stop();
+  track.stop();
+  t.end();
+});
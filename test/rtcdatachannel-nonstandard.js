@@ -0,0 +1,317 @@
+'use strict';
+
+const tape = require('tape');
+const { nonstandard } = require('..');
+const { negotiateRTCPeerConnections } = require('./lib/pc');
+
+async function createDataChannels(options = {}) {
+  let dc1;
+  let dc2Promise;
+  const [pc1, pc2] = await negotiateRTCPeerConnections({
+    withPc1(pc1) {
+      dc1 = pc1.createDataChannel('test', options);
+    },
+    withPc2(pc2) {
+      dc2Promise = new Promise(resolve => {
+        pc2.ondatachannel = ({ channel }) => resolve(channel);
+      });
+    }
+  });
+  const dc2 = await dc2Promise;
+  if (dc1.readyState !== 'open') {
+    await new Promise(resolve => { dc1.onopen = resolve; });
+  }
+  return { pc1, pc2, dc1, dc2 };
+}
+
+function receive(dc, n) {
+  const messages = [];
+  return new Promise(resolve => {
+    dc.onmessage = ({ data }) => {
+      messages.push(data);
+      if (messages.length === n) {
+        resolve(messages);
+      }
+    };
+  });
+}
+
+tape('.sendMany(messages) sends an Array of strings and ArrayBuffers', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  dc2.binaryType = 'arraybuffer';
+  const received = receive(dc2, 3);
+  t.throws(() => dc1.sendMany(['foo', 42]), TypeError, 'rejects the whole batch if any message is invalid');
+  t.equal(dc1.sendMany(['foo', new Uint8Array([1, 2, 3]), 'bar']), 3, 'returns the number of messages accepted');
+  const [a, b, c] = await received;
+  t.equal(a, 'foo');
+  t.deepEqual([...new Uint8Array(b)], [1, 2, 3]);
+  t.equal(c, 'bar');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.sendMany(buffer, offsets) sends slices of one ArrayBuffer', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  dc2.binaryType = 'arraybuffer';
+  const received = receive(dc2, 3);
+  const buffer = new Uint8Array([1, 2, 3, 4, 5, 6]);
+  t.throws(() => dc1.sendMany(buffer, [0, 4, 2]), RangeError, 'rejects offsets that are not ascending');
+  t.throws(() => dc1.sendMany(buffer, [0, 7]), RangeError, 'rejects offsets outside the buffer');
+  t.equal(dc1.sendMany(buffer, new Uint32Array([0, 1, 3])), 3, 'returns the number of messages accepted');
+  const messages = (await received).map(message => [...new Uint8Array(message)]);
+  t.deepEqual(messages, [[1], [2, 3], [4, 5, 6]]);
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.messageBatching', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  t.equal(dc2.messageBatching, 'none');
+  t.throws(() => { dc2.messageBatching = 'bogus'; }, TypeError);
+
+  dc2.messageBatching = 'array';
+  const batches = [];
+  const arrays = new Promise(resolve => {
+    let n = 0;
+    dc2.onmessages = ({ data }) => {
+      batches.push(data.length);
+      n += data.length;
+      if (n === 3) {
+        resolve();
+      }
+    };
+  });
+  dc1.sendMany(['a', 'bc', 'def']);
+  await arrays;
+  t.ok(batches.length >= 1 && batches.length <= 3, '"array" delivers messages in "messages" events');
+
+  dc2.messageBatching = 'packed';
+  const packed = [];
+  const lengths = [];
+  const packedMessages = new Promise(resolve => {
+    dc2.onmessages = event => {
+      packed.push(...new Uint8Array(event.data));
+      lengths.push(...event.lengths);
+      if (lengths.length === 2) {
+        resolve();
+      }
+    };
+  });
+  dc1.sendMany([new Uint8Array([1, 2]), 'x']);
+  await packedMessages;
+  t.deepEqual(packed, [1, 2, 'x'.charCodeAt(0)], '"packed" delivers the bytes of every message');
+  t.deepEqual(lengths, [2, 1], '"packed" delivers the length of every message');
+
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.bufferedAmountLowThreshold', async t => {
+  const { pc1, pc2, dc1 } = await createDataChannels();
+  t.equal(dc1.bufferedAmountLowThreshold, 0);
+  dc1.bufferedAmountLowThreshold = 65536;
+  t.equal(dc1.bufferedAmountLowThreshold, 65536);
+  const bufferedAmountLow = new Promise(resolve => {
+    dc1.onbufferedamountlow = resolve;
+  });
+  const message = new Uint8Array(16384);
+  for (let i = 0; i < 256; i++) {
+    dc1.send(message);
+  }
+  t.ok(dc1.bufferedAmount > dc1.bufferedAmountLowThreshold, 'sending fills the buffer past the threshold');
+  await bufferedAmountLow;
+  t.ok(dc1.bufferedAmount <= dc1.bufferedAmountLowThreshold, '"bufferedamountlow" fires once the buffer drains to the threshold');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.createStream() pipes data through the RTCDataChannel', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  const writable = dc1.createStream({ highWaterMark: 65536 });
+  const readable = dc2.createStream({ highWaterMark: 65536 });
+  const chunk = Buffer.alloc(100000, 7);
+  const n = 64;
+  const done = new Promise((resolve, reject) => {
+    let received = 0;
+    readable.on('data', data => {
+      if (!data.every(x => x === 7)) {
+        reject(new Error('received unexpected data'));
+      }
+      received += data.length;
+      if (received === chunk.length * n) {
+        resolve();
+      }
+    });
+    readable.on('error', reject);
+  });
+  for (let i = 0; i < n; i++) {
+    if (!writable.write(chunk)) {
+      await new Promise(resolve => writable.once('drain', resolve));
+    }
+  }
+  await done;
+  t.pass('received every byte written');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.createStream() keeps reading after the writable side ends', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  const stream = dc1.createStream();
+  await new Promise(resolve => stream.end('hello', resolve));
+  t.equal(dc1.readyState, 'open', 'the RTCDataChannel stays open');
+  const data = new Promise(resolve => stream.once('data', resolve));
+  dc2.send('world');
+  t.equal(String(await data), 'world', 'the stream still reads');
+  const closed = new Promise(resolve => { dc1.onclose = resolve; });
+  stream.destroy();
+  await closed;
+  t.pass('destroying the stream closes the RTCDataChannel');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.createStream({ allowHalfOpen: false }) closes the RTCDataChannel when ended', async t => {
+  const { pc1, pc2, dc1 } = await createDataChannels();
+  const stream = dc1.createStream({ allowHalfOpen: false });
+  const closed = new Promise(resolve => { dc1.onclose = resolve; });
+  stream.end();
+  await closed;
+  t.pass('the RTCDataChannel is closed');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.createStream() fails once more than maxPausedBytes are held', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  const readable = dc2.createStream({ highWaterMark: 1024, maxPausedBytes: 4096 });
+  const closed = new Promise(resolve => { dc2.onclose = resolve; });
+  const error = new Promise(resolve => readable.once('error', resolve));
+  // Nothing reads from the stream, so it pauses the RTCDataChannel.
+  const message = new Uint8Array(1024);
+  for (let i = 0; i < 16; i++) {
+    dc1.send(message);
+  }
+  t.ok(/maxPausedBytes/.test((await error).message), 'the stream is destroyed with an error');
+  await closed;
+  t.pass('the RTCDataChannel is closed');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.setReceiveRing(sharedArrayBuffer)', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  t.throws(() => dc2.setReceiveRing(new ArrayBuffer(1024)), TypeError);
+  t.throws(() => dc2.setReceiveRing(new SharedArrayBuffer(16)), RangeError);
+
+  const ring = new SharedArrayBuffer(1024);
+  const reader = new nonstandard.SharedRingReader(ring);
+  dc2.setReceiveRing(ring);
+  dc2.onmessage = () => t.fail('messages written to the ring are not dispatched');
+
+  const messages = [];
+  const received = new Promise(resolve => {
+    dc2.onringdata = () => {
+      let message;
+      while ((message = reader.read()) !== null) {
+        messages.push(message);
+      }
+      if (messages.length === 2) {
+        resolve();
+      }
+    };
+  });
+  dc1.sendMany(['hello', new Uint8Array([1, 2, 3])]);
+  await received;
+  t.equal(messages[0], 'hello');
+  t.deepEqual([...new Uint8Array(messages[1])], [1, 2, 3]);
+  t.equal(reader.dropped, 0);
+
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('RTCDataChannels with protocol "x-node-webrtc-fragmentation" send large messages', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels({ protocol: 'x-node-webrtc-fragmentation' });
+  dc2.binaryType = 'arraybuffer';
+  t.equal(dc2.maxReceivedMessageSize, 256 * 1024 * 1024, 'maxReceivedMessageSize defaults to 256 MiB');
+  const received = receive(dc2, 2);
+  const message = new Uint8Array(4 * 1024 * 1024);
+  message.forEach((_, i) => { message[i] = i; });
+  const text = 'x'.repeat(1024 * 1024);
+  dc1.send(message);
+  dc1.send(text);
+  const [binary, string] = await received;
+  t.equal(binary.byteLength, message.byteLength, 'received the binary message in one piece');
+  t.ok(new Uint8Array(binary).every((x, i) => x === (i & 0xff)), 'received the binary message intact');
+  t.equal(string, text, 'received the text message in one piece');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('RTCDataChannels with protocol "x-node-webrtc-deflate" compress messages', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels({
+    protocol: 'x-node-webrtc-fragmentation,x-node-webrtc-deflate'
+  });
+  dc2.binaryType = 'arraybuffer';
+  t.equal(dc1.compressionThreshold, 1024, 'compressionThreshold defaults to 1024');
+  const received = receive(dc2, 3);
+  const json = JSON.stringify(new Array(10000).fill({ hello: 'world' }));
+  const binary = new Uint8Array(256 * 1024);
+  dc1.send(json);
+  dc1.send(binary);
+  dc1.send('small');
+  const [string, arrayBuffer, small] = await received;
+  t.equal(string, json, 'received the text message intact');
+  t.equal(arrayBuffer.byteLength, binary.byteLength, 'received the binary message intact');
+  t.equal(small, 'small', 'received the small message intact');
+  const { messagesSent, bytesSent } = dc1.getCounters();
+  t.equal(messagesSent, 3);
+  t.equal(bytesSent, json.length + binary.byteLength + 'small'.length, 'bytesSent counts bytes before compression');
+  t.equal(dc2.getCounters().bytesReceived, bytesSent, 'bytesReceived counts bytes after decompression');
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.sendMany(messages) on a closed RTCDataChannel with protocol "x-node-webrtc-deflate" throws InvalidStateError', async t => {
+  const { pc1, pc2, dc1 } = await createDataChannels({ protocol: 'x-node-webrtc-deflate' });
+  dc1.close();
+  t.throws(() => dc1.sendMany(['hello']), /RTCDataChannel.readyState is not 'open'/);
+  pc1.close();
+  pc2.close();
+  t.end();
+});
+
+tape('.getCounters()', async t => {
+  const { pc1, pc2, dc1, dc2 } = await createDataChannels();
+  const received = receive(dc2, 2);
+  dc1.send('hello');
+  dc1.send(new Uint8Array(10));
+  await received;
+  const sent = dc1.getCounters();
+  t.equal(sent.messagesSent, 2);
+  t.equal(sent.bytesSent, 15);
+  t.equal(sent.sendFailures, 0);
+  t.ok(sent.peakBufferedAmount > 0, 'peakBufferedAmount includes messages sent');
+  const counters = dc2.getCounters();
+  t.equal(counters.messagesReceived, 2);
+  t.equal(counters.bytesReceived, 15);
+  t.ok(counters.queuedTime >= 0);
+  ['peakBufferedAmount', 'queuedTime'].forEach(key => {
+    t.equal(typeof counters[key], 'number', key);
+  });
+  pc1.close();
+  pc2.close();
+  t.end();
+});
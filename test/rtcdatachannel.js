@@ -30,3 +30,23 @@ tape('.negotiated', t => {
   pc.close();
   t.end();
 });
+
+tape('Calling .sendMany(messages) when .readyState is "closed" throws InvalidStateError', t => {
+  const pc = new RTCPeerConnection();
+  const dc = pc.createDataChannel('hello');
+  pc.close();
+  t.throws(() => dc.sendMany(['world']), /RTCDataChannel.readyState is not 'open'/);
+  t.end();
+});
+
+tape('.messageBatching cannot be changed while a stream is attached', t => {
+  const pc = new RTCPeerConnection();
+  const dc = pc.createDataChannel('hello');
+  dc.messageBatching = 'array';
+  const stream = dc.createStream();
+  t.equal(dc.messageBatching, 'none', 'createStream turns batching off');
+  t.throws(() => { dc.messageBatching = 'packed'; }, /while a stream is attached/);
+  stream.destroy();
+  pc.close();
+  t.end();
+});
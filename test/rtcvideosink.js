@@ -2,8 +2,8 @@
 
 const test = require('tape');
 
-const { RTCVideoSink, RTCVideoSource } = require('..').nonstandard;
-const { I420Frame } = require('./lib/frame');
+const { getFrameBufferPoolMetrics, RTCVideoSink, RTCVideoSource } = require('..').nonstandard;
+const { I420Frame, RgbaFrame } = require('./lib/frame');
 
 test('RTCVideoSink', t => {
   const source = new RTCVideoSource();
@@ -17,9 +17,162 @@ test('RTCVideoSink', t => {
     t.equal(inputFrame.width, outputFrame.width);
     t.equal(inputFrame.height, outputFrame.height);
     t.deepEqual(inputFrame.data, outputFrame.data);
+    t.deepEqual(outputFrame.layout, [
+      { offset: 0, stride: 160 },
+      { offset: 160 * 120, stride: 80 },
+      { offset: 160 * 120 * 5 / 4, stride: 80 }
+    ], 'layout describes each plane');
     sink.stop();
     t.ok(sink.stopped, 'RTCVideoSink initially is finally stopped');
     track.stop();
     t.end();
   });
 });
+
+test('RTCVideoSink drops the oldest frames once over its highWaterMark', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  t.equal(sink.highWaterMark, 0, 'highWaterMark defaults to 0 (unlimited)');
+  t.equal(sink.framesDropped, 0, 'framesDropped is initially 0');
+  sink.highWaterMark = 2;
+  t.equal(sink.highWaterMark, 2, 'highWaterMark can be set');
+
+  const framesReceived = [];
+  sink.onframe = ({ frame }) => framesReceived.push(frame);
+
+  // Each frame is wider than the last, so that we can tell which were dispatched.
+  for (let i = 1; i <= 10; i++) {
+    source.onFrame(new I420Frame(16 * i, 16));
+  }
+
+  return new Promise(resolve => setTimeout(resolve, 100)).then(() => {
+    t.deepEqual(framesReceived.map(frame => frame.width), [16 * 9, 16 * 10],
+      'only the latest highWaterMark frames were dispatched');
+    t.equal(sink.framesDropped, 8, 'framesDropped counts the rest');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});
+
+test('RTCVideoSink with coalesce delivers only the latest frame', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track, { coalesce: true });
+
+  const framesReceived = [];
+  sink.onframe = ({ frame }) => framesReceived.push(frame);
+
+  for (let i = 0; i < 9; i++) {
+    source.onFrame(new I420Frame(160, 120));
+  }
+  source.onFrame(new I420Frame(320, 240));
+
+  return new Promise(resolve => setTimeout(resolve, 100)).then(() => {
+    t.equal(framesReceived.length, 1, 'only one frame was dispatched');
+    t.equal(framesReceived[0].width, 320, 'the frame dispatched was the latest');
+    t.equal(sink.framesDropped, 9, 'framesDropped counts the frames replaced');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});
+
+test('RTCVideoSink scales frames to scaleResolutionTo or maxPixelCount', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const scaled = new RTCVideoSink(track, { scaleResolutionTo: { width: 80, height: 64 } });
+  const capped = new RTCVideoSink(track, { maxPixelCount: 320 * 240 / 4 });
+  const scaledFrame = new Promise(resolve => { scaled.onframe = ({ frame }) => resolve(frame); });
+  const cappedFrame = new Promise(resolve => { capped.onframe = ({ frame }) => resolve(frame); });
+  source.onFrame(new I420Frame(320, 240));
+  return Promise.all([scaledFrame, cappedFrame]).then(([frame1, frame2]) => {
+    t.deepEqual([frame1.width, frame1.height], [80, 64], 'scaled to scaleResolutionTo');
+    t.equal(frame1.data.byteLength, 80 * 64 * 3 / 2);
+    t.deepEqual([frame2.width, frame2.height], [160, 120], 'scaled down to maxPixelCount');
+    scaled.stop();
+    capped.stop();
+    track.stop();
+    t.end();
+  });
+});
+
+test('RTCVideoSink drops frames above maxFramerate', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  t.throws(() => new RTCVideoSink(track, { maxFramerate: 0 }), TypeError, 'maxFramerate must be positive');
+  const sink = new RTCVideoSink(track, { maxFramerate: 1 });
+
+  const framesReceived = [];
+  sink.onframe = ({ frame }) => framesReceived.push(frame);
+
+  for (let i = 0; i < 10; i++) {
+    source.onFrame(new I420Frame(160, 120));
+  }
+
+  return new Promise(resolve => setTimeout(resolve, 100)).then(() => {
+    t.equal(framesReceived.length, 1, 'only one frame was dispatched');
+    t.equal(sink.framesDropped, 0, 'frames skipped for maxFramerate are not counted as dropped');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});
+
+test('RTCVideoSink converts frames to format', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  t.throws(() => new RTCVideoSink(track, { format: 'YUY2' }), TypeError, 'format must be supported');
+  const formats = ['I420', 'RGBA', 'BGRA', 'NV12'];
+  const sinks = formats.map(format => new RTCVideoSink(track, { format }));
+  const frames = Promise.all(sinks.map(sink => new Promise(resolve => { sink.onframe = ({ frame }) => resolve(frame); })));
+  // A pure red frame, so that swapping red and blue would show.
+  const red = new RgbaFrame(160, 120);
+  for (let i = 0; i < red.data.length; i += 4) {
+    red.data[i] = 255;
+    red.data[i + 3] = 255;
+  }
+  const input = I420Frame.fromRgba(red);
+  const expected = RgbaFrame.fromI420(input).data;
+  source.onFrame(input);
+  return frames.then(([i420, rgba, bgra, nv12]) => {
+    t.deepEqual([i420, rgba, bgra, nv12].map(frame => frame.format), formats, 'frames have the requested formats');
+    t.equal(rgba.data.byteLength, 160 * 120 * 4);
+    t.deepEqual(rgba.layout, [{ offset: 0, stride: 160 * 4 }]);
+    t.ok(expected[0] > 200 && expected[1] < 50 && expected[2] < 50 && expected[3] === 255, 'the frame is red');
+    t.deepEqual(Array.from(rgba.data.slice(0, 4)), Array.from(expected.slice(0, 4)), 'RGBA is red, green, blue, alpha');
+    t.deepEqual(Array.from(bgra.data.slice(0, 4)), [expected[2], expected[1], expected[0], expected[3]],
+      'BGRA is blue, green, red, alpha');
+    t.ok(rgba.data.every((value, i) => value === expected[i]), 'every RGBA pixel matches');
+    t.equal(nv12.data.byteLength, 160 * 120 * 3 / 2);
+    t.deepEqual(nv12.layout, [{ offset: 0, stride: 160 }, { offset: 160 * 120, stride: 160 }]);
+    sinks.forEach(sink => sink.stop());
+    track.stop();
+    t.end();
+  });
+});
+
+test('RTCVideoSink frames can be released back to the frame buffer pool', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  const before = getFrameBufferPoolMetrics();
+  function nextFrame() {
+    const framePromise = new Promise(resolve => { sink.onframe = ({ frame }) => resolve(frame); });
+    source.onFrame(new I420Frame(160, 120));
+    return framePromise.then(frame => {
+      t.equal(frame.release(), true, 'release returns true the first time');
+      t.equal(frame.data.byteLength, 0, 'release empties data');
+      t.equal(frame.release(), false, 'release returns false afterwards');
+    });
+  }
+  return nextFrame().then(nextFrame).then(nextFrame).then(() => {
+    const after = getFrameBufferPoolMetrics();
+    t.ok(after.hits > before.hits, 'released buffers are reused');
+    t.equal(typeof after.pooledBytes, 'number');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});
@@ -0,0 +1,71 @@
+'use strict';
+
+const path = require('path');
+const tape = require('tape');
+const { Worker } = require('worker_threads');
+
+const { RTCVideoSink, RTCVideoSource } = require('..').nonstandard;
+const { I420Frame } = require('./lib/frame');
+
+const workerSource = `
+'use strict';
+
+const { parentPort } = require('worker_threads');
+
+const { RTCPeerConnection } = require(${JSON.stringify(path.join(__dirname, '..'))});
+const { RTCVideoSink, RTCVideoSource } = require(${JSON.stringify(path.join(__dirname, '..'))}).nonstandard;
+const { I420Frame } = require(${JSON.stringify(path.join(__dirname, 'lib', 'frame'))});
+
+const source = new RTCVideoSource();
+const track = source.createTrack();
+const sink = new RTCVideoSink(track);
+
+const frameReceived = new Promise(resolve => { sink.onframe = ({ frame }) => resolve(frame); });
+source.onFrame(new I420Frame(160, 120));
+
+frameReceived.then(frame => {
+  sink.stop();
+  track.stop();
+  const pc = new RTCPeerConnection();
+  pc.createDataChannel('test');
+  return pc.createOffer().then(offer => {
+    pc.close();
+    parentPort.postMessage({ width: frame.width, height: frame.height, sdp: offer.sdp });
+  });
+}).catch(error => {
+  parentPort.postMessage({ error: error.message });
+});
+`;
+
+function runWorker() {
+  return new Promise((resolve, reject) => {
+    const worker = new Worker(workerSource, { eval: true });
+    worker.once('message', resolve);
+    worker.once('error', reject);
+  });
+}
+
+tape('the addon can be loaded and used from several workers at once', t => {
+  return Promise.all([runWorker(), runWorker()]).then(results => {
+    results.forEach(result => {
+      t.equal(result.error, undefined, 'the worker did not fail');
+      t.equal(result.width, 160, 'the worker received a frame');
+      t.ok(result.sdp.includes('m=application'), 'the worker created an offer');
+    });
+    t.end();
+  });
+});
+
+tape('the main thread still works after workers exit', t => {
+  const source = new RTCVideoSource();
+  const track = source.createTrack();
+  const sink = new RTCVideoSink(track);
+  const frameReceived = new Promise(resolve => { sink.onframe = resolve; });
+  source.onFrame(new I420Frame(160, 120));
+  return frameReceived.then(() => {
+    t.pass('the main thread received a frame');
+    sink.stop();
+    track.stop();
+    t.end();
+  });
+});